@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+#include <chrono>
+
+#include "sk/fmt.h"
+
+namespace bench {
+    // Keeps the optimizer from discarding a value that is only computed for timing.
+    template<typename T>
+    inline void do_not_optimize(const T& value) noexcept {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Runs `f` `iterations` times and returns the average time per iteration in nanoseconds.
+    template<typename F>
+    double measure_ns(size_t iterations, F&& f) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            f();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        auto elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        return elapsed / static_cast<double>(iterations);
+    }
+
+    inline void report(const char* name, double ns_per_iteration) {
+        sk::println("{:<48} {:>12.2} ns/iter", name, ns_per_iteration);
+    }
+}
@@ -0,0 +1,1219 @@
+#include "sk/fmt.h"
+#include "sk/array.h"
+#include "sk/list.h"
+#include "sk/small-list.h"
+#include "sk/hash-map.h"
+#include "sk/hash-set.h"
+#include "sk/flat-set.h"
+#include "sk/deque.h"
+#include "sk/spsc-queue.h"
+#include "sk/mpmc-queue.h"
+#include "sk/segmented-list.h"
+#include "sk/slot-map.h"
+#include "sk/defer.h"
+#include "sk/mem/c-allocator.h"
+#include "sk/mem/arena-allocator.h"
+#include "sk/mem/size-class-allocator.h"
+#include "sk/mem/concurrent-arena-allocator.h"
+#include "sk/mem/tlsf-allocator.h"
+#include "sk/mem/huge-page-allocator.h"
+#include "sk/mem/persistent-arena-allocator.h"
+#include "sk/gfx/canvas.h"
+
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE__)
+static float sum_aligned(sk::Array<float> fs) {
+    // Four independent accumulators so the loop is bound by loads rather than add latency.
+    auto a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (size_t i = 0; i + 16 <= fs.len; i += 16) {
+        a0 = _mm_add_ps(a0, _mm_load_ps(&fs.items[i + 0]));
+        a1 = _mm_add_ps(a1, _mm_load_ps(&fs.items[i + 4]));
+        a2 = _mm_add_ps(a2, _mm_load_ps(&fs.items[i + 8]));
+        a3 = _mm_add_ps(a3, _mm_load_ps(&fs.items[i + 12]));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+static float sum_unaligned(sk::Array<float> fs) {
+    // Four independent accumulators so the loop is bound by loads rather than add latency.
+    auto a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (size_t i = 0; i + 16 <= fs.len; i += 16) {
+        a0 = _mm_add_ps(a0, _mm_loadu_ps(&fs.items[i + 0]));
+        a1 = _mm_add_ps(a1, _mm_loadu_ps(&fs.items[i + 4]));
+        a2 = _mm_add_ps(a2, _mm_loadu_ps(&fs.items[i + 8]));
+        a3 = _mm_add_ps(a3, _mm_loadu_ps(&fs.items[i + 12]));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+void arena_alignment_bench() {
+#if defined(__SSE__)
+    constexpr size_t count = 4 * 1024; // fits in L1 so the loads themselves dominate
+    constexpr size_t iterations = 200000;
+
+    auto arena = sk::ArenaAllocator{ &sk::c_allocator, 256 * 1024 };
+    defer { arena.destroy(); };
+
+    // Knock the bump pointer off any useful boundary before each allocation.
+    arena.alloc<char>(12);
+    auto aligned = arena.alloc<float>(count, 64);
+
+    arena.alloc<char>(12);
+    auto raw = arena.alloc<float>(count + 1, 64);
+    auto unaligned = raw.slice(1, count); // every load straddles a 16-byte boundary
+
+    std::fill(aligned.begin(), aligned.end(), 1.0f);
+    std::fill(unaligned.begin(), unaligned.end(), 1.0f);
+
+    sk::println("arena alignment ({} floats, aligned at {}, unaligned at {})", count, aligned.items, unaligned.items);
+
+    auto aligned_ns = bench::measure_ns(iterations, [&]{
+        bench::do_not_optimize(sum_aligned(aligned));
+    });
+    bench::report("aligned _mm_load_ps (64-byte)", aligned_ns);
+
+    auto unaligned_ns = bench::measure_ns(iterations, [&]{
+        bench::do_not_optimize(sum_unaligned(unaligned));
+    });
+    bench::report("unaligned _mm_loadu_ps (+4 bytes)", unaligned_ns);
+#else
+    sk::println("arena alignment: skipped, SSE is not available");
+#endif
+}
+
+void arena_reset_bench() {
+    constexpr size_t iterations = 100000;
+    constexpr size_t allocations_per_request = 64;
+
+    // Simulates a per-request arena: a burst of small allocations followed by
+    // throwing everything away.
+    auto request = [](sk::ArenaAllocator& arena) {
+        for (size_t i = 0; i < allocations_per_request; i++) {
+            auto ns = arena.alloc<uint64_t>(16 + i);
+            ns[0] = i;
+            bench::do_not_optimize(ns.items);
+        }
+    };
+
+    sk::println("arena per-request reuse ({} allocations per request)", allocations_per_request);
+
+    auto destroy_ns = bench::measure_ns(iterations, [&]{
+        auto arena = sk::ArenaAllocator{ &sk::c_allocator, 4096 };
+        request(arena);
+        arena.destroy();
+    });
+    bench::report("destroy after every request", destroy_ns);
+
+    auto arena = sk::ArenaAllocator{ &sk::c_allocator, 4096, { 2, 64 * 1024 } };
+    defer { arena.destroy(); };
+
+    auto reset_ns = bench::measure_ns(iterations, [&]{
+        request(arena);
+        arena.reset();
+    });
+    bench::report("reset() with block recycling", reset_ns);
+}
+
+// Each thread keeps a window of live allocations with pseudo-random sizes
+// and replaces one per iteration, mimicking List/StringBuilder growth churn.
+static double churn_ns(sk::Allocator& ator, size_t thread_count, size_t iterations) {
+    constexpr size_t window = 256;
+
+    auto worker = [&](size_t seed) {
+        sk::Array<uint8_t> live[window] = {};
+        uint32_t state = static_cast<uint32_t>(seed * 2654435761u + 1);
+
+        for (size_t i = 0; i < iterations; i++) {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+
+            auto& slot = live[state % window];
+            if (slot.items) {
+                ator.free(slot);
+            }
+
+            auto size = 8 + (state >> 8) % 1024;
+            slot = ator.alloc<uint8_t>(size);
+            slot[0] = static_cast<uint8_t>(i);
+        }
+
+        for (auto& slot : live) {
+            if (slot.items) {
+                ator.free(slot);
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+    return elapsed / static_cast<double>(thread_count * iterations);
+}
+
+void size_class_allocator_bench() {
+    constexpr size_t iterations = 1000000;
+
+    // Always go up to at least 4 threads so contention shows even on small machines.
+    auto max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4) max_threads = 4;
+
+    sk::println("multi-threaded alloc/free churn ({} iterations per thread)", iterations);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        auto c_ns = churn_ns(sk::c_allocator, threads, iterations);
+        auto sc_ns = churn_ns(sk::size_class_allocator, threads, iterations);
+
+        bench::report(sk::format("CAllocator          {:>2} threads", threads).c_str(), c_ns);
+        bench::report(sk::format("SizeClassAllocator  {:>2} threads", threads).c_str(), sc_ns);
+    }
+
+    auto stats = sk::SizeClassAllocator::stats(sk::SizeClassAllocator::class_of(512));
+    sk::println("{}", stats);
+}
+
+// The alternative to a concurrent arena: one ArenaAllocator behind a lock.
+struct LockedArenaAllocator : sk::Allocator {
+    sk::ArenaAllocator arena;
+    std::mutex lock;
+
+    LockedArenaAllocator(sk::Allocator* allocator, size_t block_size) : arena(allocator, block_size) {}
+
+    sk::Array<uint8_t> on_alloc(size_t size, uint32_t align) override {
+        std::lock_guard<std::mutex> guard{ lock };
+        return arena.on_alloc(size, align);
+    }
+
+    sk::Optional<sk::Array<uint8_t>> on_resize(sk::Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override {
+        std::lock_guard<std::mutex> guard{ lock };
+        return arena.on_resize(buf, buf_align, new_size);
+    }
+
+    void on_free(sk::Array<uint8_t> buf, uint32_t buf_align) override {
+    }
+};
+
+static double shared_arena_ns(sk::Allocator& ator, size_t thread_count, size_t allocations) {
+    auto worker = [&]() {
+        for (size_t i = 0; i < allocations; i++) {
+            auto ns = ator.alloc<uint64_t>(1 + i % 8);
+            ns[0] = i;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+    return elapsed / static_cast<double>(thread_count * allocations);
+}
+
+void concurrent_arena_bench() {
+    constexpr size_t allocations = 1000000;
+    constexpr size_t block_size = 1024 * 1024;
+
+    auto max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4) max_threads = 4;
+
+    sk::println("shared frame arena ({} allocations per thread)", allocations);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        {
+            auto arena = LockedArenaAllocator{ &sk::c_allocator, block_size };
+            auto ns = shared_arena_ns(arena, threads, allocations);
+            arena.arena.destroy();
+            bench::report(sk::format("mutex + ArenaAllocator    {:>2} threads", threads).c_str(), ns);
+        }
+
+        {
+            auto arena = sk::ConcurrentArenaAllocator{ &sk::c_allocator, block_size };
+            auto ns = shared_arena_ns(arena, threads, allocations);
+            arena.destroy();
+            bench::report(sk::format("ConcurrentArenaAllocator  {:>2} threads", threads).c_str(), ns);
+        }
+    }
+}
+
+template<typename A>
+static void build_small_lists(A& arena, size_t lists, size_t items_per_list) {
+    for (size_t l = 0; l < lists; l++) {
+        sk::List<uint32_t, A> list;
+        for (size_t i = 0; i < items_per_list; i++) {
+            list.append(arena, static_cast<uint32_t>(i));
+        }
+        bench::do_not_optimize(list.items);
+    }
+}
+
+template<typename A>
+static void bump_small_objects(A& arena, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        auto xs = arena.template alloc<uint64_t>(2);
+        xs[0] = i;
+        bench::do_not_optimize(xs.items);
+    }
+}
+
+void static_allocator_policy_bench() {
+    constexpr size_t iterations = 200;
+    constexpr size_t lists = 10000;
+    constexpr size_t items_per_list = 8;
+    constexpr size_t objects = 100000;
+
+    auto arena = sk::ArenaAllocator{ &sk::c_allocator, 1024 * 1024 };
+    defer { arena.destroy(); };
+    sk::Allocator& dynamic = arena;
+
+    sk::println("virtual vs static arena dispatch");
+
+    auto dynamic_list_ns = bench::measure_ns(iterations, [&]{
+        build_small_lists(dynamic, lists, items_per_list);
+        arena.reset();
+    });
+    bench::report("List<u32>::append via Allocator&", dynamic_list_ns / (lists * items_per_list));
+
+    auto static_list_ns = bench::measure_ns(iterations, [&]{
+        build_small_lists(arena, lists, items_per_list);
+        arena.reset();
+    });
+    bench::report("List<u32, ArenaAllocator>::append", static_list_ns / (lists * items_per_list));
+
+    auto dynamic_alloc_ns = bench::measure_ns(iterations, [&]{
+        bump_small_objects(dynamic, objects);
+        arena.reset();
+    });
+    bench::report("alloc<u64>(2) via Allocator&", dynamic_alloc_ns / objects);
+
+    auto static_alloc_ns = bench::measure_ns(iterations, [&]{
+        bump_small_objects(arena, objects);
+        arena.reset();
+    });
+    bench::report("alloc<u64>(2) via ArenaAllocator&", static_alloc_ns / objects);
+}
+
+// Times every alloc and free individually so the tail, not just the mean,
+// is visible. Sizes and lifetimes are random over a fixed window of slots.
+static void latency_percentiles(const char* name, sk::Allocator& ator, size_t iterations) {
+    constexpr size_t window = 1024;
+
+    sk::Array<uint8_t> live[window] = {};
+    std::vector<uint32_t> alloc_ns, free_ns;
+    alloc_ns.reserve(iterations);
+    free_ns.reserve(iterations);
+
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < iterations; i++) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+
+        auto& slot = live[state % window];
+        if (slot.items) {
+            auto start = std::chrono::steady_clock::now();
+            ator.free(slot);
+            auto end = std::chrono::steady_clock::now();
+            free_ns.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+
+        auto size = 16 + (state >> 8) % 4096;
+        auto start = std::chrono::steady_clock::now();
+        slot = ator.alloc<uint8_t>(size);
+        auto end = std::chrono::steady_clock::now();
+        alloc_ns.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+        slot[0] = static_cast<uint8_t>(i);
+    }
+
+    for (auto& slot : live) {
+        if (slot.items) {
+            ator.free(slot);
+        }
+    }
+
+    auto print = [&](const char* op, std::vector<uint32_t>& samples) {
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) { return samples[static_cast<size_t>(q * static_cast<double>(samples.size() - 1))]; };
+        sk::println("{:<12} {:<6} p50 {:>6} ns   p99 {:>6} ns   p99.9 {:>6} ns   max {:>8} ns",
+            name, op, at(0.5), at(0.99), at(0.999), samples.back());
+    };
+    print("alloc", alloc_ns);
+    print("free", free_ns);
+}
+
+void tlsf_latency_bench() {
+    constexpr size_t iterations = 1000000;
+
+    auto tlsf = sk::TLSFAllocator::make(&sk::c_allocator, 64 * 1024 * 1024).expect("Failed to reserve TLSF pool.");
+    defer { tlsf.destroy(); };
+
+    sk::println("per-operation latency, random sizes 16..4111 ({} iterations, includes timer overhead)", iterations);
+    latency_percentiles("CAllocator", sk::c_allocator, iterations);
+    latency_percentiles("TLSF", tlsf, iterations);
+}
+
+// Walking an 8K frame column by column touches a new page on every pixel,
+// which is where TLB reach matters most.
+static uint64_t column_pass(sk::Canvas& canvas) {
+    uint64_t sum = 0;
+    for (size_t x = 0; x < canvas.width; x++) {
+        for (size_t y = 0; y < canvas.height; y++) {
+            sum += canvas.pixels[y * canvas.stride + x];
+        }
+    }
+    return sum;
+}
+
+void huge_page_bench() {
+    constexpr size_t width = 7680, height = 4320, passes = 5;
+
+    sk::HugePageAllocator huge(&sk::c_allocator);
+
+    auto small_pages = sk::Canvas::make(sk::c_allocator, width, height);
+    auto huge_pages = sk::Canvas::make(huge, width, height);
+    defer { small_pages.destroy(sk::c_allocator); };
+    defer { huge_pages.destroy(huge); };
+
+    for (size_t i = 0; i < width * height; i++) {
+        small_pages.pixels[i] = static_cast<sk::Pixel>(i);
+        huge_pages.pixels[i] = static_cast<sk::Pixel>(i);
+    }
+
+    sk::println("column-major pass over a {}x{} canvas", width, height);
+    auto small_ns = bench::measure_ns(passes, [&]{ bench::do_not_optimize(column_pass(small_pages)); });
+    auto huge_ns = bench::measure_ns(passes, [&]{ bench::do_not_optimize(column_pass(huge_pages)); });
+    bench::report("CAllocator (4 KiB pages), per pixel", small_ns / (width * height));
+    bench::report("HugePageAllocator, per pixel", huge_ns / (width * height));
+
+    auto info = huge.query(huge_pages.pixels.items);
+    if (info.is_some()) {
+        sk::println("{}", info.unwrap());
+    }
+}
+
+// Stand-in for an expensive lookup table: every entry takes some real work.
+template<typename A>
+static void build_table(sk::List<uint64_t>& table, A& ator, size_t entries) {
+    for (size_t i = 0; i < entries; i++) {
+        uint64_t h = i;
+        for (int round = 0; round < 16; round++) {
+            h ^= h >> 33; h *= 0xff51afd7ed558ccdull; h ^= h >> 33;
+        }
+        table.append(ator, h);
+    }
+}
+
+void persistent_arena_bench() {
+    constexpr size_t entries = 4 * 1024 * 1024;
+    const char* path = "/tmp/sklib-bench.arena";
+    ::remove(path);
+
+    {
+        auto arena = sk::PersistentArenaAllocator::open(path, 64 * 1024 * 1024).expect("Failed to open arena file.");
+        auto table = arena.create<sk::List<uint64_t>>();
+        build_table(*table, arena, entries);
+        arena.set_root(table);
+        arena.flush();
+        arena.close();
+    }
+
+    sk::println("startup cost of a {} entry lookup table", entries);
+    auto rebuild_ns = bench::measure_ns(1, [&]{
+        sk::List<uint64_t> table;
+        build_table(table, sk::c_allocator, entries);
+        bench::do_not_optimize(table[entries - 1]);
+        table.destroy(sk::c_allocator);
+    });
+    auto reopen_ns = bench::measure_ns(1, [&]{
+        auto arena = sk::PersistentArenaAllocator::open(path, 0).expect("Failed to reopen arena file.");
+        auto table = arena.root<sk::List<uint64_t>>();
+        bench::do_not_optimize((*table)[entries - 1]);
+        arena.close();
+    });
+    bench::report("rebuild into CAllocator", rebuild_ns);
+    bench::report("reopen PersistentArenaAllocator", reopen_ns);
+
+    ::remove(path);
+}
+
+struct SmallObject {
+    uint64_t a, b;
+};
+
+// 10k small objects through the virtual interface, one call each versus one batch.
+static void batch_bench(const char* name, sk::Allocator& ator, void (*reset)(sk::Allocator&)) {
+    constexpr size_t objects = 10000, iterations = 200;
+
+    std::vector<SmallObject*> ptrs(objects);
+    auto single_ns = bench::measure_ns(iterations, [&]{
+        for (auto& ptr : ptrs) {
+            ptr = ator.alloc<SmallObject>(1).items;
+        }
+        bench::do_not_optimize(ptrs.back());
+        for (auto ptr : ptrs) {
+            ator.free(1, ptr);
+        }
+        reset(ator);
+    });
+    auto batch_ns = bench::measure_ns(iterations, [&]{
+        auto batch = sk::Array<SmallObject*>{ objects, ptrs.data() };
+        ator.alloc_batch(batch);
+        bench::do_not_optimize(ptrs.back());
+        ator.free_batch(batch);
+        reset(ator);
+    });
+
+    bench::report(sk::format("{} alloc/free per object", name).c_str(), single_ns / objects);
+    bench::report(sk::format("{} alloc_batch/free_batch", name).c_str(), batch_ns / objects);
+}
+
+void batch_allocation_bench() {
+    sk::ArenaAllocator arena(&sk::c_allocator, 1024 * 1024);
+    defer { arena.destroy(); };
+
+    sk::println("10000 small objects, per object");
+    batch_bench("CAllocator", sk::c_allocator, [](sk::Allocator&) {});
+    batch_bench("ArenaAllocator", arena, [](sk::Allocator& ator) { static_cast<sk::ArenaAllocator&>(ator).reset(); });
+}
+
+// Hides malloc's slack the way CAllocator used to, to show what adopting it saves.
+struct ExactSizeAllocator : sk::Allocator {
+    size_t resizes = 0;
+
+    sk::Array<uint8_t> on_alloc(size_t size, uint32_t align) override {
+        auto allocation = sk::c_allocator.on_alloc(size, align);
+        allocation.len = allocation.items ? size : 0;
+        return allocation;
+    }
+
+    sk::Optional<sk::Array<uint8_t>> on_resize(sk::Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override {
+        resizes++;
+        auto resized = sk::c_allocator.on_resize(buf, buf_align, new_size);
+        if (resized.is_none()) {
+            return sk::None;
+        }
+        auto new_buf = resized.unwrap();
+        new_buf.len = new_size;
+        return new_buf;
+    }
+
+    void on_free(sk::Array<uint8_t> buf, uint32_t buf_align) override {
+        sk::c_allocator.on_free(buf, buf_align);
+    }
+};
+
+struct CountingAllocator : sk::Allocator {
+    size_t resizes = 0;
+
+    sk::Array<uint8_t> on_alloc(size_t size, uint32_t align) override {
+        return sk::c_allocator.on_alloc(size, align);
+    }
+
+    sk::Optional<sk::Array<uint8_t>> on_resize(sk::Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override {
+        resizes++;
+        return sk::c_allocator.on_resize(buf, buf_align, new_size);
+    }
+
+    void on_free(sk::Array<uint8_t> buf, uint32_t buf_align) override {
+        sk::c_allocator.on_free(buf, buf_align);
+    }
+};
+
+template<typename A>
+static double append_small_lists_ns(A& ator, size_t lists, size_t items_per_list) {
+    return bench::measure_ns(lists, [&]{
+        sk::List<uint8_t> list;
+        for (size_t i = 0; i < items_per_list; i++) {
+            list.append(ator, static_cast<uint8_t>(i));
+        }
+        bench::do_not_optimize(list.items);
+        list.destroy(ator);
+    });
+}
+
+void usable_size_bench() {
+    constexpr size_t lists = 100000, items_per_list = 100;
+
+    ExactSizeAllocator exact;
+    CountingAllocator usable;
+    auto exact_ns = append_small_lists_ns(exact, lists, items_per_list);
+    auto usable_ns = append_small_lists_ns(usable, lists, items_per_list);
+
+    sk::println("List<u8> of {} items, reallocations per list: exact {} vs usable size {}",
+        items_per_list, exact.resizes / lists, usable.resizes / lists);
+    bench::report("List growth, requested capacity", exact_ns);
+    bench::report("List growth, usable capacity", usable_ns);
+}
+
+// Owns a heap buffer, so moving it means stealing the pointer and nulling
+// the source, and it has a destructor: not trivially copyable.
+template<bool Relocatable>
+struct Blob {
+    uint8_t* data;
+    size_t size;
+
+    Blob(size_t size) noexcept : data(size > 0 ? static_cast<uint8_t*>(malloc(size)) : nullptr), size(size) {}
+    Blob(const Blob& other) noexcept : Blob(other.size) { memcpy(data, other.data, size); }
+    Blob(Blob&& other) noexcept : data(other.data), size(other.size) { other.data = nullptr; }
+    ~Blob() noexcept { ::free(data); }
+};
+
+namespace sk {
+    template<> struct is_trivially_relocatable<Blob<true>> : std::true_type {};
+}
+
+template<bool Relocatable>
+static double grow_blob_list_ns(size_t lists, size_t items_per_list) {
+    return bench::measure_ns(lists, [&]{
+        sk::List<Blob<Relocatable>> list;
+        for (size_t i = 0; i < items_per_list; i++) {
+            list.emplace(sk::c_allocator, 0);
+        }
+        bench::do_not_optimize(list.items);
+        list.destroy(sk::c_allocator);
+    });
+}
+
+void relocation_bench() {
+    constexpr size_t lists = 100, items_per_list = 10000;
+
+    sk::println("List of {} heap-owning objects (left empty so growth dominates)", items_per_list);
+    bench::report("element-wise move on growth", grow_blob_list_ns<false>(lists, items_per_list));
+    bench::report("trivially relocatable (realloc)", grow_blob_list_ns<true>(lists, items_per_list));
+}
+
+void bulk_list_bench() {
+    constexpr size_t chunks = 1000, chunk_len = 4096, iterations = 20;
+
+    std::vector<int> chunk(chunk_len);
+    for (size_t i = 0; i < chunk_len; i++) {
+        chunk[i] = static_cast<int>(i);
+    }
+    auto chunk_array = sk::Array<int>{ chunk_len, chunk.data() };
+
+    auto append_ns = bench::measure_ns(iterations, [&]{
+        sk::List<int> list;
+        for (size_t c = 0; c < chunks; c++) {
+            for (int n : chunk) {
+                list.append(sk::c_allocator, n);
+            }
+        }
+        bench::do_not_optimize(list.items);
+        list.destroy(sk::c_allocator);
+    });
+    auto extend_ns = bench::measure_ns(iterations, [&]{
+        sk::List<int> list;
+        for (size_t c = 0; c < chunks; c++) {
+            list.extend(sk::c_allocator, chunk_array);
+        }
+        bench::do_not_optimize(list.items);
+        list.destroy(sk::c_allocator);
+    });
+
+    sk::println("ingesting {} chunks of {} ints, per element", chunks, chunk_len);
+    bench::report("append loop", append_ns / (chunks * chunk_len));
+    bench::report("extend", extend_ns / (chunks * chunk_len));
+}
+
+template<typename L>
+static double build_short_lists_ns(size_t lists) {
+    uint32_t state = 2463534242u;
+    return bench::measure_ns(lists, [&]{
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+
+        L list;
+        auto count = 1 + state % 7;
+        for (uint32_t i = 0; i < count; i++) {
+            list.append(sk::c_allocator, static_cast<int>(i));
+        }
+        bench::do_not_optimize(list[0]);
+        list.destroy(sk::c_allocator);
+    });
+}
+
+void small_list_bench() {
+    constexpr size_t lists = 1000000;
+
+    sk::println("lists of 1..7 ints, build then destroy");
+    bench::report("List<int>", build_short_lists_ns<sk::List<int>>(lists));
+    bench::report("SmallList<int, 8>", build_short_lists_ns<sk::SmallList<int, 8>>(lists));
+}
+
+// Per-operation costs over `keys`, which are inserted, looked up (hits, then
+// misses from `absent`) and erased in that order.
+template<typename Insert, typename Find, typename Erase>
+static void hash_map_ops(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& absent, Insert&& insert, Find&& find, Erase&& erase) {
+    size_t i = 0;
+    auto insert_ns = bench::measure_ns(keys.size(), [&]{ insert(keys[i++]); });
+
+    i = 0;
+    auto hit_ns = bench::measure_ns(keys.size(), [&]{ bench::do_not_optimize(find(keys[i++])); });
+
+    i = 0;
+    auto miss_ns = bench::measure_ns(absent.size(), [&]{ bench::do_not_optimize(find(absent[i++])); });
+
+    i = 0;
+    auto erase_ns = bench::measure_ns(keys.size(), [&]{ erase(keys[i++]); });
+
+    sk::println("{:<24} insert {:>7.2}  hit {:>7.2}  miss {:>7.2}  erase {:>7.2} ns/op", name, insert_ns, hit_ns, miss_ns, erase_ns);
+}
+
+void hash_map_bench() {
+    sk::println("random u64 keys, per-operation cost");
+
+    for (size_t n : { size_t{ 1000 }, size_t{ 100000 }, size_t{ 1000000 }, size_t{ 10000000 } }) {
+        std::vector<uint64_t> keys(n), absent(n);
+        uint64_t state = 0x9e3779b97f4a7c15ull;
+        for (size_t i = 0; i < n; i++) {
+            // Odd keys are present, even ones are known misses
+            state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+            keys[i] = state | 1;
+            absent[i] = state & ~uint64_t{ 1 };
+        }
+
+        sk::println("n = {}", n);
+
+        sk::HashMap<uint64_t, uint64_t> map;
+        hash_map_ops("  sk::HashMap", keys, absent,
+            [&](uint64_t k) { map.insert(sk::c_allocator, k, k); },
+            [&](uint64_t k) { return map.contains(k); },
+            [&](uint64_t k) { map.remove(k); });
+        map.destroy(sk::c_allocator);
+
+        std::unordered_map<uint64_t, uint64_t> std_map;
+        hash_map_ops("  std::unordered_map", keys, absent,
+            [&](uint64_t k) { std_map[k] = k; },
+            [&](uint64_t k) { return std_map.find(k) != std_map.end(); },
+            [&](uint64_t k) { std_map.erase(k); });
+    }
+}
+
+void set_dedup_bench() {
+    constexpr size_t ids = 1000000;
+    constexpr size_t batch = 4096;
+
+    // About half of the ids are repeats
+    std::vector<uint64_t> stream(ids);
+    uint64_t state = 88172645463325252ull;
+    for (auto& id : stream) {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        id = state % (ids / 2);
+    }
+
+    sk::println("deduplicate {} ids, then probe each once", ids);
+
+    sk::HashSet<uint64_t> hash_set;
+    auto hash_insert_ns = bench::measure_ns(1, [&]{
+        for (auto id : stream) {
+            hash_set.insert(sk::c_allocator, id);
+        }
+    }) / ids;
+    size_t i = 0;
+    auto hash_find_ns = bench::measure_ns(ids, [&]{ bench::do_not_optimize(hash_set.contains(stream[i++])); });
+    hash_set.destroy(sk::c_allocator);
+
+    sk::FlatSet<uint64_t> flat_set;
+    auto flat_insert_ns = bench::measure_ns(1, [&]{
+        for (size_t at = 0; at < ids; at += batch) {
+            auto len = ids - at < batch ? ids - at : batch;
+            flat_set.insert_many(sk::c_allocator, sk::Array<uint64_t>{ len, &stream[at] });
+        }
+    }) / ids;
+    i = 0;
+    auto flat_find_ns = bench::measure_ns(ids, [&]{ bench::do_not_optimize(flat_set.contains(stream[i++])); });
+    flat_set.destroy(sk::c_allocator);
+
+    std::unordered_set<uint64_t> std_set;
+    auto std_insert_ns = bench::measure_ns(1, [&]{
+        for (auto id : stream) {
+            std_set.insert(id);
+        }
+    }) / ids;
+    i = 0;
+    auto std_find_ns = bench::measure_ns(ids, [&]{ bench::do_not_optimize(std_set.count(stream[i++])); });
+
+    auto report = [](const char* name, double insert_ns, double find_ns) {
+        sk::println("{:<32} insert {:>7.2}  contains {:>7.2} ns/id", name, insert_ns, find_ns);
+    };
+    report("sk::HashSet", hash_insert_ns, hash_find_ns);
+    report("sk::FlatSet (batches of 4096)", flat_insert_ns, flat_find_ns);
+    report("std::unordered_set", std_insert_ns, std_find_ns);
+}
+
+void fifo_queue_bench() {
+    constexpr size_t ops = 1000000;
+
+    sk::println("FIFO at a steady depth, one push and one pop per iteration");
+    for (size_t depth : { size_t{ 16 }, size_t{ 1024 }, size_t{ 16384 } }) {
+        sk::println("depth = {}", depth);
+
+        sk::List<uint64_t> list;
+        for (size_t i = 0; i < depth; i++) {
+            list.append(sk::c_allocator, i);
+        }
+        uint64_t next = depth;
+        bench::report("  List (remove_range(0, 1))", bench::measure_ns(ops / 10, [&]{
+            bench::do_not_optimize(list[0]);
+            list.remove_range(0, 1);
+            list.append(sk::c_allocator, next++);
+        }));
+        list.destroy(sk::c_allocator);
+
+        sk::Deque<uint64_t> deque;
+        for (size_t i = 0; i < depth; i++) {
+            deque.push_back(sk::c_allocator, i);
+        }
+        bench::report("  Deque", bench::measure_ns(ops, [&]{
+            bench::do_not_optimize(deque.pop_front().unwrap());
+            deque.push_back(sk::c_allocator, next++);
+        }));
+
+        // Consuming in bulk through the slices
+        bench::report("  Deque (64 at a time, per item)", bench::measure_ns(ops / 64, [&]{
+            auto popped = deque.pop_front_n(64);
+            uint64_t sum = 0;
+            for (auto x : popped.first) {
+                sum += x;
+            }
+            for (auto x : popped.second) {
+                sum += x;
+            }
+            bench::do_not_optimize(sum);
+            for (size_t i = 0; i < 64; i++) {
+                deque.push_back(sk::c_allocator, next++);
+            }
+        }) / 64);
+        deque.destroy(sk::c_allocator);
+
+        std::deque<uint64_t> std_deque;
+        for (size_t i = 0; i < depth; i++) {
+            std_deque.push_back(i);
+        }
+        bench::report("  std::deque", bench::measure_ns(ops, [&]{
+            bench::do_not_optimize(std_deque.front());
+            std_deque.pop_front();
+            std_deque.push_back(next++);
+        }));
+    }
+}
+
+// The baseline the lock-free queues replace: a mutex-guarded container.
+struct MutexQueue {
+    std::mutex mutex;
+    sk::Deque<uint64_t> deque;
+
+    ~MutexQueue() {
+        this->deque.destroy(sk::c_allocator);
+    }
+
+    bool push(uint64_t value) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->deque.push_back(sk::c_allocator, value);
+    }
+
+    size_t push_n(sk::Array<uint64_t> items) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->deque.push_back(sk::c_allocator, items) ? items.len : 0;
+    }
+
+    sk::Optional<uint64_t> pop() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->deque.pop_front();
+    }
+
+    size_t pop_n(sk::Array<uint64_t> out) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto popped = this->deque.pop_front_n(out.len);
+        memcpy(out.items, popped.first.items, popped.first.len * sizeof(uint64_t));
+        memcpy(out.items + popped.first.len, popped.second.items, popped.second.len * sizeof(uint64_t));
+        return popped.size();
+    }
+};
+
+// Average time per item to move `items` from the producers to the consumers,
+// `batch` at a time. Threads yield whenever the queue is full or empty.
+template<typename Q>
+static double queue_throughput_ns(Q& queue, size_t producers, size_t consumers, size_t items, size_t batch) {
+    auto per_producer = items / producers;
+    auto total = per_producer * producers;
+    std::atomic<size_t> consumed{ 0 };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&]{
+            uint64_t buf[64];
+            for (size_t i = 0; i < per_producer; ) {
+                if (batch == 1) {
+                    while (!queue.push(i)) {
+                        std::this_thread::yield();
+                    }
+                    i++;
+                    continue;
+                }
+
+                auto count = per_producer - i < batch ? per_producer - i : batch;
+                for (size_t k = 0; k < count; k++) {
+                    buf[k] = i + k;
+                }
+
+                size_t pushed = 0;
+                while (pushed < count) {
+                    pushed += queue.push_n(sk::Array<uint64_t>{ count - pushed, buf + pushed });
+                    if (pushed < count) {
+                        std::this_thread::yield();
+                    }
+                }
+                i += count;
+            }
+        });
+    }
+
+    for (size_t c = 0; c < consumers; c++) {
+        threads.emplace_back([&]{
+            uint64_t buf[64];
+            uint64_t sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                size_t count = 0;
+                if (batch == 1) {
+                    auto item = queue.pop();
+                    if (item.is_some()) {
+                        sum += item.unwrap();
+                        count = 1;
+                    }
+                } else {
+                    count = queue.pop_n(sk::Array<uint64_t>{ batch, buf });
+                    for (size_t k = 0; k < count; k++) {
+                        sum += buf[k];
+                    }
+                }
+
+                if (count == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                consumed.fetch_add(count, std::memory_order_relaxed);
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(total);
+}
+
+// Round trips of one message through a pair of queues, bounced back by a
+// second thread.
+template<typename Q>
+static void queue_round_trip(const char* name, Q& there, Q& back, size_t round_trips) {
+    std::vector<uint32_t> samples;
+    samples.reserve(round_trips);
+
+    std::thread echo([&]{
+        for (size_t i = 0; i < round_trips; i++) {
+            auto item = there.pop();
+            while (item.is_none()) {
+                std::this_thread::yield();
+                item = there.pop();
+            }
+            while (!back.push(item.unwrap())) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t i = 0; i < round_trips; i++) {
+        auto start = std::chrono::steady_clock::now();
+        while (!there.push(i)) {
+            std::this_thread::yield();
+        }
+        while (back.pop().is_none()) {
+            std::this_thread::yield();
+        }
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    echo.join();
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[static_cast<size_t>(q * static_cast<double>(samples.size() - 1))]; };
+    sk::println("{:<24} round trip p50 {:>8} ns   p99 {:>8} ns", name, at(0.5), at(0.99));
+}
+
+void lock_free_queue_bench() {
+    constexpr size_t items = 2000000;
+    constexpr size_t capacity = 4096;
+
+    auto max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4) max_threads = 4;
+
+    sk::println("one producer, one consumer ({} items)", items);
+    for (size_t batch : { size_t{ 1 }, size_t{ 64 } }) {
+        MutexQueue locked;
+        bench::report(sk::format("mutex + Deque       batch {:>2}", batch).c_str(), queue_throughput_ns(locked, 1, 1, items, batch));
+
+        sk::SpscQueue<uint64_t> spsc;
+        spsc.init(sk::c_allocator, capacity);
+        bench::report(sk::format("SpscQueue           batch {:>2}", batch).c_str(), queue_throughput_ns(spsc, 1, 1, items, batch));
+        spsc.destroy(sk::c_allocator);
+
+        sk::MpmcQueue<uint64_t> mpmc;
+        mpmc.init(sk::c_allocator, capacity);
+        bench::report(sk::format("MpmcQueue           batch {:>2}", batch).c_str(), queue_throughput_ns(mpmc, 1, 1, items, batch));
+        mpmc.destroy(sk::c_allocator);
+    }
+
+    sk::println("N producers, N consumers ({} items)", items);
+    for (size_t threads = 1; threads <= max_threads / 2; threads *= 2) {
+        for (size_t batch : { size_t{ 1 }, size_t{ 32 } }) {
+            MutexQueue locked;
+            bench::report(sk::format("mutex + Deque  {:>2}x{:<2} batch {:>2}", threads, threads, batch).c_str(), queue_throughput_ns(locked, threads, threads, items, batch));
+
+            sk::MpmcQueue<uint64_t> mpmc;
+            mpmc.init(sk::c_allocator, capacity);
+            bench::report(sk::format("MpmcQueue      {:>2}x{:<2} batch {:>2}", threads, threads, batch).c_str(), queue_throughput_ns(mpmc, threads, threads, items, batch));
+            mpmc.destroy(sk::c_allocator);
+        }
+    }
+
+    constexpr size_t round_trips = 100000;
+    {
+        MutexQueue there, back;
+        queue_round_trip("mutex + Deque", there, back, round_trips);
+    }
+    {
+        sk::SpscQueue<uint64_t> there, back;
+        there.init(sk::c_allocator, capacity);
+        back.init(sk::c_allocator, capacity);
+        queue_round_trip("SpscQueue", there, back, round_trips);
+        there.destroy(sk::c_allocator);
+        back.destroy(sk::c_allocator);
+    }
+}
+
+void segmented_list_bench() {
+    constexpr size_t count = 10000000;
+    constexpr size_t passes = 10;
+
+    sk::println("append {} ints, then sum them", count);
+
+    sk::List<int> list;
+    bench::report("List append", bench::measure_ns(1, [&]{
+        for (size_t i = 0; i < count; i++) {
+            list.append(sk::c_allocator, static_cast<int>(i));
+        }
+    }) / count);
+
+    sk::SegmentedList<int> segmented;
+    bench::report("SegmentedList append", bench::measure_ns(1, [&]{
+        for (size_t i = 0; i < count; i++) {
+            segmented.append(sk::c_allocator, static_cast<int>(i));
+        }
+    }) / count);
+
+    bench::report("List sum", bench::measure_ns(passes, [&]{
+        int64_t sum = 0;
+        for (auto x : list) {
+            sum += x;
+        }
+        bench::do_not_optimize(sum);
+    }) / count);
+
+    bench::report("SegmentedList sum by index", bench::measure_ns(passes, [&]{
+        int64_t sum = 0;
+        for (size_t i = 0; i < segmented.len; i++) {
+            sum += segmented[i];
+        }
+        bench::do_not_optimize(sum);
+    }) / count);
+
+    bench::report("SegmentedList sum by iterator", bench::measure_ns(passes, [&]{
+        int64_t sum = 0;
+        for (auto x : segmented) {
+            sum += x;
+        }
+        bench::do_not_optimize(sum);
+    }) / count);
+
+    bench::report("SegmentedList sum by chunk", bench::measure_ns(passes, [&]{
+        int64_t sum = 0;
+        for (auto chunk : segmented.chunks()) {
+            for (auto x : chunk) {
+                sum += x;
+            }
+        }
+        bench::do_not_optimize(sum);
+    }) / count);
+
+    list.destroy(sk::c_allocator);
+    segmented.destroy(sk::c_allocator);
+}
+
+struct BenchEntity {
+    float position[3];
+    float velocity[3];
+};
+
+void slot_map_bench() {
+    constexpr size_t entities = 1000000;
+    constexpr size_t passes = 10;
+
+    sk::println("{} entities: integrate positions, then random lookups", entities);
+
+    // Entities owned by pointer, allocated among other allocations as they
+    // would be in a long-running program
+    std::vector<BenchEntity*> pointers(entities);
+    std::vector<sk::Array<uint8_t>> clutter(entities);
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < entities; i++) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        pointers[i] = sk::c_allocator.create<BenchEntity>();
+        *pointers[i] = BenchEntity{ { 0, 0, 0 }, { 1, 2, 3 } };
+        clutter[i] = sk::c_allocator.alloc<uint8_t>(16 + state % 256);
+    }
+    std::shuffle(pointers.begin(), pointers.end(), std::mt19937{ 42 });
+
+    sk::SlotMap<BenchEntity> map;
+    std::vector<sk::SlotHandle> handles(entities);
+    for (size_t i = 0; i < entities; i++) {
+        handles[i] = map.insert(sk::c_allocator, BenchEntity{ { 0, 0, 0 }, { 1, 2, 3 } }).unwrap();
+    }
+
+    auto integrate = [](BenchEntity& e) {
+        for (int k = 0; k < 3; k++) {
+            e.position[k] += e.velocity[k] * 0.016f;
+        }
+    };
+
+    bench::report("update through pointers (per entity)", bench::measure_ns(passes, [&]{
+        for (auto e : pointers) {
+            integrate(*e);
+        }
+    }) / entities);
+
+    bench::report("update SlotMap values (per entity)", bench::measure_ns(passes, [&]{
+        for (auto& e : map.values()) {
+            integrate(e);
+        }
+    }) / entities);
+
+    std::vector<size_t> order(entities);
+    for (size_t i = 0; i < entities; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937{ 7 });
+
+    size_t i = 0;
+    bench::report("random pointer deref", bench::measure_ns(entities, [&]{
+        bench::do_not_optimize(pointers[order[i++]]->position[0]);
+    }));
+
+    i = 0;
+    bench::report("random SlotMap::get", bench::measure_ns(entities, [&]{
+        bench::do_not_optimize(map.get(handles[order[i++]]).unwrap().position[0]);
+    }));
+
+    for (size_t k = 0; k < entities; k++) {
+        sk::c_allocator.destroy(pointers[k]);
+        sk::c_allocator.free(clutter[k]);
+    }
+    map.destroy(sk::c_allocator);
+}
+
+int main() {
+    arena_alignment_bench();
+    std::cout << std::endl;
+
+    arena_reset_bench();
+    std::cout << std::endl;
+
+    size_class_allocator_bench();
+    std::cout << std::endl;
+
+    concurrent_arena_bench();
+    std::cout << std::endl;
+
+    static_allocator_policy_bench();
+    std::cout << std::endl;
+
+    tlsf_latency_bench();
+    std::cout << std::endl;
+
+    huge_page_bench();
+    std::cout << std::endl;
+
+    persistent_arena_bench();
+    std::cout << std::endl;
+
+    batch_allocation_bench();
+    std::cout << std::endl;
+
+    usable_size_bench();
+    std::cout << std::endl;
+
+    relocation_bench();
+    std::cout << std::endl;
+
+    bulk_list_bench();
+    std::cout << std::endl;
+
+    small_list_bench();
+    std::cout << std::endl;
+
+    hash_map_bench();
+    std::cout << std::endl;
+
+    set_dedup_bench();
+    std::cout << std::endl;
+
+    fifo_queue_bench();
+    std::cout << std::endl;
+
+    lock_free_queue_bench();
+    std::cout << std::endl;
+
+    segmented_list_bench();
+    std::cout << std::endl;
+
+    slot_map_bench();
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -19,6 +19,39 @@ project "sklib"
         "src"
     }
 
+	links { "pthread", "dl" }
+	linkoptions { "-rdynamic" }
+
+	filter "configurations:Debug"
+		defines { "DEBUG" }
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "NDEBUG" }
+		optimize "On"
+
+
+project "sklib-bench"
+	kind "ConsoleApp"
+	language "C++"
+    cppdialect "C++17"
+
+	files {
+		"sk/**.h",
+        "sk/**.cpp",
+
+        "bench/**.h",
+        "bench/**.cpp"
+	}
+
+	includedirs { 
+        ".", 
+        "bench"
+    }
+
+	links { "pthread", "dl" }
+	linkoptions { "-rdynamic" }
+
 	filter "configurations:Debug"
 		defines { "DEBUG" }
 		symbols "On"
@@ -101,4 +101,24 @@ template<typename T>
             writer.print("{}]", alternate ? "\n" : "");
         }
     };
+
+    // Index of the first item of sorted `items` that is not less than `value`.
+    // Each step picks the next half with a conditional move rather than a
+    // branch, so lookups do not pay for mispredictions on random keys.
+    template<typename T>
+    size_t lower_bound(Array<T> items, const T& value) noexcept {
+        if (items.len == 0) {
+            return 0;
+        }
+
+        const T* base = items.items;
+        auto len = items.len;
+        while (len > 1) {
+            auto half = len / 2;
+            base = base[half] < value ? base + half : base;
+            len -= half;
+        }
+
+        return static_cast<size_t>(base - items.items) + (*base < value);
+    }
 }
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "mem/relocate.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+
+namespace sk {
+    // A run of deque items that may wrap around the end of the buffer, as at
+    // most two contiguous pieces: `first` is followed by `second` in order.
+    template<typename T>
+    struct DequeSlices {
+        Array<T> first;
+        Array<T> second;
+
+        size_t size() const noexcept {
+            return this->first.len + this->second.len;
+        }
+    };
+
+    // A growable ring buffer with O(1) pushes and pops at both ends. The
+    // capacity is kept a power of two so positions wrap with a mask instead
+    // of a division. Like List, the allocator is passed to every operation
+    // that may grow and copies are shallow.
+    template<typename T, typename A = Allocator>
+    struct Deque {
+        // === Structures ===
+        struct Iterator {
+            const Deque<T, A>* deque;
+            size_t index;
+
+            T& operator*() const noexcept {
+                return (*this->deque)[this->index];
+            }
+
+            Iterator& operator++() noexcept {
+                this->index++;
+                return *this;
+            }
+
+            bool operator!=(const Iterator& other) const noexcept {
+                return this->index != other.index;
+            }
+        };
+
+        // === Data ===
+        size_t capacity; // 0 or a power of two
+        size_t len;
+        size_t _head;
+        T* items;
+        size_t _alloc_len; // items the allocator returned, at least `capacity`
+
+        // === Constructors / Assignments ===
+        Deque() noexcept : capacity(0), len(0), _head(0), items(nullptr), _alloc_len(0) {}
+        Deque(const Deque<T, A>&) noexcept = default;
+        Deque(Deque<T, A>&&) noexcept = default;
+
+        Deque<T, A>& operator=(const Deque<T, A>&) noexcept = default;
+        Deque<T, A>& operator=(Deque<T, A>&&) noexcept = default;
+
+        // === Associated Functions ===
+        size_t size() const noexcept {
+            return this->len;
+        }
+
+        bool is_empty() const noexcept {
+            return this->len == 0;
+        }
+
+        // Buffer position of the item at `index`.
+        size_t _slot(size_t index) const noexcept {
+            return (this->_head + index) & (this->capacity - 1);
+        }
+
+        T& operator[](size_t index) const noexcept {
+            assert(index < this->len);
+            return this->items[this->_slot(index)];
+        }
+
+        Optional<T&> at(size_t index) const noexcept {
+            if (index >= this->len) {
+                return None;
+            }
+            return this->items[this->_slot(index)];
+        }
+
+        Optional<T&> front() const noexcept {
+            return this->at(0);
+        }
+
+        Optional<T&> back() const noexcept {
+            return this->at(this->len - 1);
+        }
+
+        // The `count` items starting at `index`, in place.
+        DequeSlices<T> slices(size_t index, size_t count) const noexcept {
+            assert(index + count <= this->len);
+            if (count == 0) {
+                return {};
+            }
+
+            auto start = this->_slot(index);
+            auto first_len = this->capacity - start;
+            if (count <= first_len) {
+                return { { count, &this->items[start] }, {} };
+            }
+            return { { first_len, &this->items[start] }, { count - first_len, this->items } };
+        }
+
+        DequeSlices<T> as_slices() const noexcept {
+            return this->slices(0, this->len);
+        }
+
+        void destroy(A& ator) noexcept {
+            this->clear();
+            if (this->items != nullptr) {
+                ator.free(this->_alloc_len, this->items);
+            }
+
+            *this = Deque<T, A>{};
+        }
+
+        void clear() noexcept {
+            auto all = this->as_slices();
+            destroy_range(all.first.items, all.first.len);
+            destroy_range(all.second.items, all.second.len);
+
+            this->len = 0;
+            this->_head = 0;
+        }
+
+        // Moves the items, unwrapped, to the front of a new buffer of at least
+        // `min_capacity` slots. Kept out of line so the pushes inline.
+        [[gnu::noinline]] bool _grow(A& ator, size_t min_capacity) noexcept {
+            auto new_capacity = size_t{ 1 };
+            while (new_capacity < min_capacity) {
+                new_capacity *= 2;
+            }
+
+            auto buf = ator.template alloc<T>(new_capacity);
+            if (buf.items == nullptr) {
+                return false;
+            }
+
+            // Adopt any extra room the allocator gave as long as masking still works
+            while (new_capacity * 2 <= buf.len) {
+                new_capacity *= 2;
+            }
+
+            auto all = this->as_slices();
+            relocate(buf.items, all.first.items, all.first.len);
+            relocate(buf.items + all.first.len, all.second.items, all.second.len);
+
+            if (this->items != nullptr) {
+                ator.free(this->_alloc_len, this->items);
+            }
+
+            this->capacity = new_capacity;
+            this->_head = 0;
+            this->items = buf.items;
+            this->_alloc_len = buf.len;
+            return true;
+        }
+
+        bool _reserve_more(A& ator, size_t additional) noexcept {
+            auto needed = this->len + additional;
+            if (needed <= this->capacity) {
+                return true;
+            }
+
+            auto new_capacity = this->capacity == 0 ? 8 : this->capacity * 2;
+            return this->_grow(ator, new_capacity > needed ? new_capacity : needed);
+        }
+
+        // Makes room for at least `min_capacity` items in total.
+        bool reserve(A& ator, size_t min_capacity) noexcept {
+            if (min_capacity <= this->capacity) {
+                return true;
+            }
+            return this->_grow(ator, min_capacity);
+        }
+
+        template<typename... Args>
+        bool emplace_back(A& ator, Args&&... args) noexcept {
+            if (!this->_reserve_more(ator, 1)) {
+                return false;
+            }
+
+            new (&this->items[this->_slot(this->len)]) T(std::forward<Args>(args)...);
+            this->len++;
+            return true;
+        }
+
+        template<typename... Args>
+        bool emplace_front(A& ator, Args&&... args) noexcept {
+            if (!this->_reserve_more(ator, 1)) {
+                return false;
+            }
+
+            auto head = (this->_head - 1) & (this->capacity - 1);
+            new (&this->items[head]) T(std::forward<Args>(args)...);
+            this->_head = head;
+            this->len++;
+            return true;
+        }
+
+        bool push_back(A& ator, const T& item) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->items[this->_slot(this->len)]) T(item);
+                this->len++;
+                return true;
+            }
+
+            // `item` may live in this deque, so copy it out before growing.
+            T copy(item);
+            return this->emplace_back(ator, std::move(copy));
+        }
+
+        bool push_back(A& ator, T&& item) noexcept {
+            return this->emplace_back(ator, std::move(item));
+        }
+
+        bool push_front(A& ator, const T& item) noexcept {
+            if (this->len < this->capacity) {
+                auto head = (this->_head - 1) & (this->capacity - 1);
+                new (&this->items[head]) T(item);
+                this->_head = head;
+                this->len++;
+                return true;
+            }
+
+            T copy(item);
+            return this->emplace_front(ator, std::move(copy));
+        }
+
+        bool push_front(A& ator, T&& item) noexcept {
+            return this->emplace_front(ator, std::move(item));
+        }
+
+        // Appends copies of all of `items`, which must not be part of this
+        // deque, as at most two block copies.
+        bool push_back(A& ator, Array<T> items) noexcept {
+            if (!this->_reserve_more(ator, items.len)) {
+                return false;
+            }
+
+            auto start = this->_slot(this->len);
+            auto first_len = this->capacity - start;
+            if (first_len > items.len) {
+                first_len = items.len;
+            }
+
+            _copy_into(&this->items[start], items.items, first_len);
+            _copy_into(this->items, items.items + first_len, items.len - first_len);
+
+            this->len += items.len;
+            return true;
+        }
+
+        Optional<T> pop_front() noexcept {
+            if (this->len == 0) {
+                return None;
+            }
+
+            auto& item = this->items[this->_head];
+            T value(std::move(item));
+            item.~T();
+
+            this->_head = this->_slot(1);
+            this->len--;
+            return value;
+        }
+
+        Optional<T> pop_back() noexcept {
+            if (this->len == 0) {
+                return None;
+            }
+
+            auto& item = this->items[this->_slot(this->len - 1)];
+            T value(std::move(item));
+            item.~T();
+
+            this->len--;
+            return value;
+        }
+
+        // Pops up to `count` items off the front and returns them in place,
+        // without copying. The slices stay valid until the next push.
+        DequeSlices<T> pop_front_n(size_t count) noexcept {
+            static_assert(std::is_trivially_destructible_v<T>, "pop_front_n hands out popped items in place, use slices and drop_front");
+
+            if (count > this->len) {
+                count = this->len;
+            }
+
+            auto popped = this->slices(0, count);
+            this->_head = this->_slot(count);
+            this->len -= count;
+            return popped;
+        }
+
+        // Destroys the first `count` items.
+        void drop_front(size_t count) noexcept {
+            assert(count <= this->len);
+
+            auto dropped = this->slices(0, count);
+            destroy_range(dropped.first.items, dropped.first.len);
+            destroy_range(dropped.second.items, dropped.second.len);
+
+            this->_head = this->_slot(count);
+            this->len -= count;
+        }
+
+        // Copies `src` into uninitialized slots starting at `dst`.
+        static void _copy_into(T* dst, const T* src, size_t count) noexcept {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (count > 0) {
+                    memcpy(dst, src, count * sizeof(T));
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    new (&dst[i]) T(src[i]);
+                }
+            }
+        }
+
+        // === Iterator Stuff ===
+        Iterator begin() const noexcept {
+            return { this, 0 };
+        }
+
+        Iterator end() const noexcept {
+            return { this, this->len };
+        }
+    };
+
+    template<typename T, typename A>
+    struct Formatter<Deque<T, A>> {
+        static void format(const Deque<T, A>& deque, std::string_view fmt, Writer& writer) {
+            bool alternate = fmt == "#";
+            writer.write_string("[");
+            for (size_t i = 0; i < deque.len; i++) {
+                writer.print("{}{}", alternate ? "\n\t" : "", deque[i]);
+                if (i + 1 < deque.len) {
+                    writer.print(",{}", alternate ? "" : " ");
+                }
+            }
+            writer.print("{}]", alternate ? "\n" : "");
+        }
+    };
+
+    template<typename T>
+    struct Formatter<DequeSlices<T>> {
+        static void format(const DequeSlices<T>& slices, std::string_view fmt, Writer& writer) {
+            writer.write_string("DequeSlices{ first: ");
+            Formatter<Array<T>>::format(slices.first, fmt, writer);
+            writer.write_string(", second: ");
+            Formatter<Array<T>>::format(slices.second, fmt, writer);
+            writer.write_string(" }");
+        }
+    };
+
+    template<typename T, typename A>
+    struct Owned<Deque<T, A>> : public IOwned<Deque<T, A>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<Deque<T, A>>(), allocator(allocator) {}
+        Owned(const Owned<Deque<T, A>>&) noexcept = default;
+        Owned(Owned<Deque<T, A>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool reserve(size_t min_capacity) noexcept {
+            return this->as_ref().reserve(allocator, min_capacity);
+        }
+
+        bool push_back(const T& item) noexcept {
+            return this->as_ref().push_back(allocator, item);
+        }
+
+        bool push_back(T&& item) noexcept {
+            return this->as_ref().push_back(allocator, std::move(item));
+        }
+
+        bool push_back(Array<T> items) noexcept {
+            return this->as_ref().push_back(allocator, items);
+        }
+
+        bool push_front(const T& item) noexcept {
+            return this->as_ref().push_front(allocator, item);
+        }
+
+        bool push_front(T&& item) noexcept {
+            return this->as_ref().push_front(allocator, std::move(item));
+        }
+
+        template<typename... Args>
+        bool emplace_back(Args&&... args) noexcept {
+            return this->as_ref().emplace_back(allocator, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        bool emplace_front(Args&&... args) noexcept {
+            return this->as_ref().emplace_front(allocator, std::forward<Args>(args)...);
+        }
+    };
+
+    template<typename T, typename A = Allocator>
+    using OwnedDeque = Owned<Deque<T, A>>;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+#include "mem/allocator.h"
+#include "mem/relocate.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+#include "list.h"
+
+namespace sk {
+    // A set kept as a sorted List. Lookups are binary searches over one
+    // contiguous array, which beats hashing for small sets and for sets that
+    // are mostly read, and iteration is in order. Single inserts shift the
+    // tail, so load in bulk with `insert_many` when possible.
+    template<typename T, typename A = Allocator>
+    struct FlatSet {
+        // === Data ===
+        List<T, A> _items;
+
+        // === Conversions ===
+        operator Array<T>() const noexcept {
+            return this->_items;
+        }
+
+        // === Associated Functions ===
+        size_t size() const noexcept {
+            return this->_items.len;
+        }
+
+        T& operator[](size_t index) const noexcept {
+            return this->_items[index];
+        }
+
+        size_t lower_bound(const T& value) const noexcept {
+            return sk::lower_bound<T>(this->_items, value);
+        }
+
+        bool contains(const T& value) const noexcept {
+            auto index = this->lower_bound(value);
+            return index < this->_items.len && this->_items.items[index] == value;
+        }
+
+        // Adds `item` if it is not already present. Returns false if the list could not grow.
+        bool insert(A& ator, const T& item) noexcept {
+            auto index = this->lower_bound(item);
+            if (index < this->_items.len && this->_items.items[index] == item) {
+                return true;
+            }
+
+            // `item` may live in this set
+            T copy(item);
+            return this->_items.insert(ator, Array<T>{ 1, &copy }, index);
+        }
+
+        // Adds all of `items` in O((n + m) + n log n): they are sorted on their
+        // own, merged in from the back into the grown list and the result is
+        // deduplicated in one pass.
+        bool insert_many(A& ator, Array<T> items) noexcept {
+            if (items.len == 0) {
+                return true;
+            }
+
+            // Copied out first since `items` may be part of this set
+            auto sorted = ator.template alloc<T>(items.len);
+            if (sorted.items == nullptr) {
+                return false;
+            }
+
+            List<T, A>::_copy_into(sorted.items, items.items, items.len);
+            std::sort(sorted.items, sorted.items + items.len);
+
+            auto old_len = this->_items.len;
+            if (!this->_items.reserve(ator, old_len + items.len)) {
+                destroy_range(sorted.items, items.len);
+                ator.free(sorted);
+                return false;
+            }
+
+            // Everything below `old_len` is constructed, everything from it up is not
+            auto dst = this->_items.items;
+            auto i = old_len;
+            auto j = items.len;
+            auto k = old_len + items.len;
+            while (j > 0) {
+                k--;
+                auto& src = i > 0 && sorted.items[j - 1] < dst[i - 1] ? dst[--i] : sorted.items[--j];
+                if (k >= old_len) {
+                    new (&dst[k]) T(std::move(src));
+                } else {
+                    dst[k] = std::move(src);
+                }
+            }
+
+            destroy_range(sorted.items, items.len);
+            ator.free(sorted);
+
+            auto end = dst + old_len + items.len;
+            auto unique_end = std::unique(dst, end);
+            destroy_range(unique_end, static_cast<size_t>(end - unique_end));
+            this->_items.len = static_cast<size_t>(unique_end - dst);
+
+            return true;
+        }
+
+        bool remove(const T& item) noexcept {
+            auto index = this->lower_bound(item);
+            if (index == this->_items.len || !(this->_items.items[index] == item)) {
+                return false;
+            }
+
+            this->_items.remove_range(index, 1);
+            return true;
+        }
+
+        void clear() noexcept {
+            destroy_range(this->_items.items, this->_items.len);
+            this->_items.len = 0;
+        }
+
+        void destroy(A& ator) noexcept {
+            this->_items.destroy(ator);
+        }
+
+        // === Iterator Stuff ===
+        T* begin() const noexcept {
+            return this->_items.items;
+        }
+
+        T* end() const noexcept {
+            return this->_items.items + this->_items.len;
+        }
+    };
+
+    template<typename T, typename A>
+    struct Formatter<FlatSet<T, A>> {
+        static void format(const FlatSet<T, A>& set, std::string_view fmt, Writer& writer) {
+            bool alternate = fmt == "#";
+            writer.write_string("{");
+            for (size_t i = 0; i < set.size(); i++) {
+                writer.print("{}{}", alternate ? "\n\t" : "", set[i]);
+                if (i + 1 < set.size()) {
+                    writer.print(",{}", alternate ? "" : " ");
+                }
+            }
+            writer.print("{}}}", alternate ? "\n" : "");
+        }
+    };
+
+    template<typename T, typename A>
+    struct Owned<FlatSet<T, A>> : public IOwned<FlatSet<T, A>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<FlatSet<T, A>>(), allocator(allocator) {}
+        Owned(const Owned<FlatSet<T, A>>&) noexcept = default;
+        Owned(Owned<FlatSet<T, A>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool insert(const T& item) noexcept {
+            return this->as_ref().insert(allocator, item);
+        }
+
+        bool insert_many(Array<T> items) noexcept {
+            return this->as_ref().insert_many(allocator, items);
+        }
+    };
+
+    template<typename T, typename A = Allocator>
+    using OwnedFlatSet = Owned<FlatSet<T, A>>;
+}
@@ -53,7 +53,11 @@ namespace sk {
     }
 
     Canvas Canvas::make(Allocator& ator, size_t width, size_t height) noexcept {
+        // Allocators may hand out more than asked for; a canvas only spans its own pixels.
         auto pixels = ator.alloc<Pixel>(width * height);
+        if (pixels.items != nullptr) {
+            pixels.len = width * height;
+        }
         return Canvas{ width, height, width, pixels };
     }
 
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "hash.h"
+#include "swiss-table.h"
+
+namespace sk {
+    template<typename K, typename V>
+    struct HashMapEntry {
+        K key;
+        V value;
+
+        // Used by the table to find the key of a slot
+        static const K& get(const HashMapEntry<K, V>& entry) noexcept {
+            return entry.key;
+        }
+    };
+
+    // Swiss-table hash map; see internal::SwissTable for the layout. Entries
+    // come from the allocator passed to each operation that may grow, like
+    // List, and copies are shallow.
+    template<typename K, typename V, typename A = Allocator, typename H = Hash<K>>
+    struct HashMap : public internal::SwissTable<HashMapEntry<K, V>, K, A, H, HashMapEntry<K, V>> {
+        using Entry = HashMapEntry<K, V>;
+
+        // === Associated Functions ===
+        Optional<V&> get(const K& key) const noexcept {
+            auto index = this->_find(key, H{}(key));
+            if (index == SIZE_MAX) {
+                return None;
+            }
+            return this->_slots[index].value;
+        }
+
+        // Inserts `key` or overwrites its value. Returns false if the table could not grow.
+        bool insert(A& ator, const K& key, V value) noexcept {
+            bool found;
+            auto index = this->_find_or_claim(ator, key, H{}(key), &found);
+            if (index == SIZE_MAX) {
+                return false;
+            }
+
+            if (found) {
+                this->_slots[index].value = std::move(value);
+            } else {
+                new (&this->_slots[index]) Entry{ key, std::move(value) };
+            }
+            return true;
+        }
+
+        // Returns the value for `key`, default constructing it first if absent.
+        Optional<V&> get_or_insert(A& ator, const K& key) noexcept {
+            bool found;
+            auto index = this->_find_or_claim(ator, key, H{}(key), &found);
+            if (index == SIZE_MAX) {
+                return None;
+            }
+
+            if (!found) {
+                new (&this->_slots[index]) Entry{ key, V() };
+            }
+            return this->_slots[index].value;
+        }
+    };
+
+    template<typename K, typename V, typename A, typename H>
+    struct Formatter<HashMap<K, V, A, H>> {
+        static void format(const HashMap<K, V, A, H>& map, std::string_view fmt, Writer& writer) {
+            bool alternate = fmt == "#";
+            writer.write_string("{");
+            size_t i = 0;
+            for (auto& entry : map) {
+                writer.print("{}{}: {}", alternate ? "\n\t" : "", entry.key, entry.value);
+                if (++i < map.len) {
+                    writer.print(",{}", alternate ? "" : " ");
+                }
+            }
+            writer.print("{}}}", alternate ? "\n" : "");
+        }
+    };
+
+    template<typename K, typename V, typename A, typename H>
+    struct Owned<HashMap<K, V, A, H>> : public IOwned<HashMap<K, V, A, H>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<HashMap<K, V, A, H>>(), allocator(allocator) {}
+        Owned(const Owned<HashMap<K, V, A, H>>&) noexcept = default;
+        Owned(Owned<HashMap<K, V, A, H>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool reserve(size_t count) noexcept {
+            return this->as_ref().reserve(allocator, count);
+        }
+
+        bool rehash(size_t min_capacity) noexcept {
+            return this->as_ref().rehash(allocator, min_capacity);
+        }
+
+        bool insert(const K& key, V value) noexcept {
+            return this->as_ref().insert(allocator, key, std::move(value));
+        }
+
+        Optional<V&> get_or_insert(const K& key) noexcept {
+            return this->as_ref().get_or_insert(allocator, key);
+        }
+    };
+
+    template<typename K, typename V, typename A = Allocator, typename H = Hash<K>>
+    using OwnedHashMap = Owned<HashMap<K, V, A, H>>;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "mem/allocator.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+#include "hash.h"
+#include "swiss-table.h"
+
+namespace sk {
+    namespace internal {
+        template<typename T>
+        struct SetKey {
+            static const T& get(const T& item) noexcept {
+                return item;
+            }
+        };
+    }
+
+    // Swiss-table hash set; see internal::SwissTable for the layout. Items come
+    // from the allocator passed to each operation that may grow, like List,
+    // and copies are shallow.
+    template<typename T, typename A = Allocator, typename H = Hash<T>>
+    struct HashSet : public internal::SwissTable<T, T, A, H, internal::SetKey<T>> {
+        // === Associated Functions ===
+
+        // Adds `item` if it is not already present, setting `*inserted` to
+        // whether it was new. Returns false if the table could not grow.
+        bool insert(A& ator, const T& item, bool* inserted = nullptr) noexcept {
+            bool found;
+            auto index = this->_find_or_claim(ator, item, H{}(item), &found);
+            if (index == SIZE_MAX) {
+                return false;
+            }
+
+            if (!found) {
+                new (&this->_slots[index]) T(item);
+            }
+            if (inserted != nullptr) {
+                *inserted = !found;
+            }
+            return true;
+        }
+
+        // Adds every item of `items`, reserving room for all of them up front.
+        bool extend(A& ator, Array<T> items) noexcept {
+            if (!this->reserve(ator, this->len + items.len)) {
+                return false;
+            }
+
+            for (auto& item : items) {
+                if (!this->insert(ator, item)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    template<typename T, typename A, typename H>
+    struct Formatter<HashSet<T, A, H>> {
+        static void format(const HashSet<T, A, H>& set, std::string_view fmt, Writer& writer) {
+            bool alternate = fmt == "#";
+            writer.write_string("{");
+            size_t i = 0;
+            for (auto& item : set) {
+                writer.print("{}{}", alternate ? "\n\t" : "", item);
+                if (++i < set.len) {
+                    writer.print(",{}", alternate ? "" : " ");
+                }
+            }
+            writer.print("{}}}", alternate ? "\n" : "");
+        }
+    };
+
+    template<typename T, typename A, typename H>
+    struct Owned<HashSet<T, A, H>> : public IOwned<HashSet<T, A, H>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<HashSet<T, A, H>>(), allocator(allocator) {}
+        Owned(const Owned<HashSet<T, A, H>>&) noexcept = default;
+        Owned(Owned<HashSet<T, A, H>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool reserve(size_t count) noexcept {
+            return this->as_ref().reserve(allocator, count);
+        }
+
+        bool rehash(size_t min_capacity) noexcept {
+            return this->as_ref().rehash(allocator, min_capacity);
+        }
+
+        bool insert(const T& item, bool* inserted = nullptr) noexcept {
+            return this->as_ref().insert(allocator, item, inserted);
+        }
+
+        bool extend(Array<T> items) noexcept {
+            return this->as_ref().extend(allocator, items);
+        }
+    };
+
+    template<typename T, typename A = Allocator, typename H = Hash<T>>
+    using OwnedHashSet = Owned<HashSet<T, A, H>>;
+}
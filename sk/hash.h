@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "string.h"
+
+namespace sk {
+    namespace internal {
+        // Murmur3's 64-bit finalizer: every input bit affects every output bit,
+        // which open addressing needs since it uses both the low and high bits.
+        inline uint64_t mix64(uint64_t x) noexcept {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdull;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ull;
+            x ^= x >> 33;
+            return x;
+        }
+    }
+
+    inline uint64_t hash_bytes(const void* data, size_t len) noexcept {
+        auto bytes = static_cast<const uint8_t*>(data);
+        uint64_t h = 0x9e3779b97f4a7c15ull ^ (len * 0xbf58476d1ce4e5b9ull);
+
+        while (len >= 8) {
+            uint64_t word;
+            memcpy(&word, bytes, 8);
+            h = (h ^ internal::mix64(word)) * 0x94d049bb133111ebull;
+            bytes += 8;
+            len -= 8;
+        }
+
+        if (len > 0) {
+            uint64_t word = 0;
+            memcpy(&word, bytes, len);
+            h = (h ^ internal::mix64(word)) * 0x94d049bb133111ebull;
+        }
+
+        return internal::mix64(h);
+    }
+
+    // Hash functor used by the hash containers. Integers, enums and pointers
+    // are handled here; other key types specialize it.
+    template<typename T>
+    struct Hash {
+        uint64_t operator()(const T& value) const noexcept {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                return internal::mix64(static_cast<uint64_t>(value));
+            } else if constexpr (std::is_pointer_v<T>) {
+                return internal::mix64(reinterpret_cast<uintptr_t>(value));
+            } else {
+                static_assert(!sizeof(T), "no sk::Hash specialization for this key type");
+                return 0;
+            }
+        }
+    };
+
+    template<> struct Hash<String> {
+        uint64_t operator()(const String& s) const noexcept {
+            return hash_bytes(s.chars, s.len);
+        }
+    };
+
+    template<> struct Hash<std::string_view> {
+        uint64_t operator()(std::string_view s) const noexcept {
+            return hash_bytes(s.data(), s.size());
+        }
+    };
+
+    template<> struct Hash<std::string> {
+        uint64_t operator()(const std::string& s) const noexcept {
+            return hash_bytes(s.data(), s.size());
+        }
+    };
+}
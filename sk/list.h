@@ -2,15 +2,21 @@
 
 #include <stdint.h>
 #include <initializer_list>
+#include <type_traits>
 
 #include "optional.h"
 #include "mem/allocator.h"
+#include "mem/relocate.h"
 #include "ptr/owned.h"
 #include "fmt.h"
 #include "array.h"
 
 namespace sk {
-    template<typename T>
+    // `A` is the allocator type every operation takes. The default, Allocator,
+    // dispatches through its virtual interface. Naming a concrete allocator
+    // such as ArenaAllocator instead binds the calls at compile time so their
+    // fast paths inline into append loops.
+    template<typename T, typename A = Allocator>
     struct List {
         // === Data ===
         size_t capacity;
@@ -19,8 +25,8 @@ namespace sk {
 
         // === Constructors / Assignments ===
         List() noexcept : capacity(0), len(0), items(nullptr) {}
-        List(const List<T>&) noexcept = default;
-        List(List<T>&&) noexcept = default;
+        List(const List<T, A>&) noexcept = default;
+        List(List<T, A>&&) noexcept = default;
 
         // === Conversions ===
         operator Array<T>() const noexcept {
@@ -62,36 +68,310 @@ namespace sk {
             return { len, ptr };
         }
 
-        void destroy(Allocator& ator) noexcept {
+        void destroy(A& ator) noexcept {
+            destroy_range(this->items, this->len);
             ator.free(this->capacity, this->items);
         }
 
-        List<T> clone(Allocator& ator) const noexcept {
-            List<T> clone;
+        List<T, A> clone(A& ator) const noexcept {
+            List<T, A> clone;
+            auto allocation = ator.template alloc<T>(this->len);
             clone.len = this->len;
-            clone.capacity = this->len;
-            clone.items = ator.alloc<T>(this->len).items;
-            memcpy(clone.items, this->items, this->len * sizeof(T));
+            clone.capacity = allocation.len;
+            clone.items = allocation.items;
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                memcpy(clone.items, this->items, this->len * sizeof(T));
+            } else {
+                for (size_t i = 0; i < this->len; i++) {
+                    new (&clone.items[i]) T(this->items[i]);
+                }
+            }
 
             return clone;
         }
 
-        bool append(Allocator& ator, const T& item) noexcept {
-            if (this->len >= this->capacity) {
-                auto new_capacity = this->capacity > 0 ? this->capacity * 2 : 1;
-                auto new_items = ator.resize(this->capacity, this->items, new_capacity);
+        // Takes whatever capacity the allocator actually handed out, which
+        // can be more than asked for (e.g. malloc's size class rounding).
+        // Trivially relocatable elements move with the allocator's resize
+        // (realloc, or in place); anything else is moved element by element.
+        bool _grow(A& ator, size_t min_capacity) noexcept {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                auto new_items = ator.resize(Array<T>{ this->capacity, this->items }, min_capacity);
                 if (new_items.is_none()) {
                     return false;
                 }
 
-                this->capacity = new_capacity;
-                this->items = new_items.unwrap();
+                auto buf = new_items.unwrap();
+                this->capacity = buf.len;
+                this->items = buf.items;
+            } else {
+                auto buf = ator.template alloc<T>(min_capacity);
+                if (buf.items == nullptr) {
+                    return false;
+                }
+
+                relocate(buf.items, this->items, this->len);
+                ator.free(this->capacity, this->items);
+
+                this->capacity = buf.len;
+                this->items = buf.items;
+            }
+
+            return true;
+        }
+
+        bool _reserve_one(A& ator) noexcept {
+            if (this->len < this->capacity) {
+                return true;
+            }
+            return this->_grow(ator, this->capacity > 0 ? this->capacity * 2 : 1);
+        }
+
+        bool append(A& ator, const T& item) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->items[this->len++]) T(item);
+                return true;
+            }
+
+            // `item` may live in this list, so copy it out before growing.
+            T copy(item);
+            if (!this->_reserve_one(ator)) {
+                return false;
+            }
+
+            new (&this->items[this->len++]) T(std::move(copy));
+            return true;
+        }
+
+        bool append(A& ator, T&& item) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->items[this->len++]) T(std::move(item));
+                return true;
+            }
+
+            // `item` may live in this list, so move it out before growing.
+            T moved(std::move(item));
+            if (!this->_reserve_one(ator)) {
+                return false;
+            }
+
+            new (&this->items[this->len++]) T(std::move(moved));
+            return true;
+        }
+
+        // Constructs the new element from `args`, in place unless the list has to grow.
+        template<typename... Args>
+        bool emplace(A& ator, Args&&... args) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->items[this->len++]) T(std::forward<Args>(args)...);
+                return true;
+            }
+
+            // `args` may refer to elements of this list, so build the element before growing.
+            T item(std::forward<Args>(args)...);
+            if (!this->_reserve_one(ator)) {
+                return false;
+            }
+
+            new (&this->items[this->len++]) T(std::move(item));
+            return true;
+        }
+
+        // === Bulk Operations ===
+        // Each of these reallocates at most once and copies with memcpy/memmove
+        // when the element type allows it.
+
+        // Grows so that `additional` more elements fit, at least doubling.
+        bool _reserve_more(A& ator, size_t additional) noexcept {
+            auto needed = this->len + additional;
+            if (needed <= this->capacity) {
+                return true;
+            }
+
+            auto new_capacity = this->capacity * 2;
+            return this->_grow(ator, new_capacity > needed ? new_capacity : needed);
+        }
+
+        // Shifts `[at, len)` up by `count` slots, leaving `[at, at + count)` uninitialized.
+        void _open_gap(size_t at, size_t count) noexcept {
+            auto tail = this->len - at;
+            if constexpr (is_trivially_relocatable_v<T>) {
+                memmove(static_cast<void*>(&this->items[at + count]), static_cast<const void*>(&this->items[at]), tail * sizeof(T));
+            } else {
+                for (size_t i = tail; i > 0; i--) {
+                    relocate(&this->items[at + count + i - 1], &this->items[at + i - 1], 1);
+                }
+            }
+        }
+
+        // Copies `src` into uninitialized slots starting at `dst`.
+        static void _copy_into(T* dst, const T* src, size_t count) noexcept {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (count > 0) {
+                    memcpy(dst, src, count * sizeof(T));
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    new (&dst[i]) T(src[i]);
+                }
+            }
+        }
+
+        // Makes room for at least `min_capacity` elements in total.
+        bool reserve(A& ator, size_t min_capacity) noexcept {
+            if (min_capacity <= this->capacity) {
+                return true;
+            }
+            return this->_grow(ator, min_capacity);
+        }
+
+        // Appends copies of all of `items`, which may be part of this list.
+        bool extend(A& ator, Array<T> items) noexcept {
+            auto aliased = items.items >= this->items && items.items < this->items + this->len;
+            auto offset = aliased ? static_cast<size_t>(items.items - this->items) : 0;
+
+            if (!this->_reserve_more(ator, items.len)) {
+                return false;
+            }
+
+            auto src = aliased ? this->items + offset : items.items;
+            _copy_into(&this->items[this->len], src, items.len);
+            this->len += items.len;
+            return true;
+        }
+
+        // Appends `count` copies of `value`.
+        bool append_n(A& ator, size_t count, const T& value) noexcept {
+            T copy(value);
+            if (!this->_reserve_more(ator, count)) {
+                return false;
+            }
+
+            for (size_t i = 0; i < count; i++) {
+                new (&this->items[this->len + i]) T(copy);
+            }
+            this->len += count;
+            return true;
+        }
+
+        // Inserts copies of `items` before index `at`. `items` must not be part of this list.
+        bool insert(A& ator, Array<T> items, size_t at) noexcept {
+            assert(at <= this->len);
+            assert(items.items + items.len <= this->items || items.items >= this->items + this->capacity);
+
+            if (!this->_reserve_more(ator, items.len)) {
+                return false;
+            }
+
+            this->_open_gap(at, items.len);
+            _copy_into(&this->items[at], items.items, items.len);
+            this->len += items.len;
+            return true;
+        }
+
+        // Removes `count` elements starting at `at`, keeping the order of the rest.
+        void remove_range(size_t at, size_t count) noexcept {
+            assert(at + count <= this->len);
+
+            destroy_range(&this->items[at], count);
+
+            auto tail = this->len - at - count;
+            if constexpr (is_trivially_relocatable_v<T>) {
+                memmove(static_cast<void*>(&this->items[at]), static_cast<const void*>(&this->items[at + count]), tail * sizeof(T));
+            } else {
+                for (size_t i = 0; i < tail; i++) {
+                    relocate(&this->items[at + i], &this->items[at + count + i], 1);
+                }
+            }
+
+            this->len -= count;
+        }
+
+        // Removes the element at `index` in O(1) by moving the last element into its place.
+        T swap_remove(size_t index) noexcept {
+            assert(index < this->len);
+
+            T removed(std::move(this->items[index]));
+            this->items[index].~T();
+
+            this->len--;
+            if (index != this->len) {
+                relocate(&this->items[index], &this->items[this->len], 1);
+            }
+
+            return removed;
+        }
+
+        // Grows with value-initialized elements or shrinks by destroying the tail.
+        bool resize(A& ator, size_t new_len) noexcept {
+            if (new_len <= this->len) {
+                destroy_range(&this->items[new_len], this->len - new_len);
+                this->len = new_len;
+                return true;
+            }
+
+            if (!this->reserve(ator, new_len)) {
+                return false;
+            }
+
+            if constexpr (std::is_trivially_default_constructible_v<T>) {
+                memset(static_cast<void*>(&this->items[this->len]), 0, (new_len - this->len) * sizeof(T));
+            } else {
+                for (size_t i = this->len; i < new_len; i++) {
+                    new (&this->items[i]) T();
+                }
+            }
+
+            this->len = new_len;
+            return true;
+        }
+
+        // For lists of individually allocated nodes, i.e. `T` is `Node*`:
+        // allocates `count` default constructed nodes with a single batch
+        // request and appends pointers to them.
+        bool append_nodes(A& ator, size_t count) noexcept {
+            static_assert(std::is_pointer_v<T>, "append_nodes needs a list of pointers");
+            using Node = std::remove_pointer_t<T>;
+
+            if (this->len + count > this->capacity) {
+                auto new_capacity = this->capacity > 0 ? this->capacity * 2 : 1;
+                if (new_capacity < this->len + count) {
+                    new_capacity = this->len + count;
+                }
+
+                if (!this->_grow(ator, new_capacity)) {
+                    return false;
+                }
+            }
+
+            auto nodes = Array<Node*>{ count, this->items + this->len };
+            if (!ator.template alloc_batch<Node>(nodes)) {
+                return false;
+            }
+
+            for (auto node : nodes) {
+                new (node) Node{};
             }
 
-            this->items[this->len++] = item;
+            this->len += count;
             return true;
         }
 
+        // Destroys and frees every node with a single batch request. The list
+        // itself is left empty but keeps its capacity.
+        void destroy_nodes(A& ator) noexcept {
+            static_assert(std::is_pointer_v<T>, "destroy_nodes needs a list of pointers");
+            using Node = std::remove_pointer_t<T>;
+
+            for (size_t i = 0; i < this->len; i++) {
+                this->items[i]->~Node();
+            }
+
+            ator.template free_batch<Node>(Array<Node*>{ this->len, this->items });
+            this->len = 0;
+        }
+
         // === Iterator Stuff ===
         T* begin() noexcept {
             return this->items;
@@ -102,7 +382,7 @@ namespace sk {
         }
 
         // === Friends ===
-        friend std::ostream& operator<<(std::ostream& s, const List<T>& list) noexcept {
+        friend std::ostream& operator<<(std::ostream& s, const List<T, A>& list) noexcept {
             s << '[';
             for (size_t i = 0; i < list.len; i++) {
                 s << list[i];
@@ -114,9 +394,9 @@ namespace sk {
         }
     };
 
-    template<typename T> 
-    struct Formatter<List<T>> {
-        static void format(const List<T>& list, std::string_view fmt, Writer& writer) {
+    template<typename T, typename A> 
+    struct Formatter<List<T, A>> {
+        static void format(const List<T, A>& list, std::string_view fmt, Writer& writer) {
             bool alternate = fmt == "#";
             writer.write_string("[");
             for (size_t i = 0; i < list.len; i++) {
@@ -129,15 +409,15 @@ namespace sk {
         }
     };
 
-    template<typename T>
-    struct Owned<List<T>> : public IOwned<List<T>> {
+    template<typename T, typename A>
+    struct Owned<List<T, A>> : public IOwned<List<T, A>> {
         // === Data ===
-        Allocator& allocator;
+        A& allocator;
 
         // === Constructors / Assignments ===
-        Owned(Allocator& allocator) noexcept : IOwned<List<T>>(), allocator(allocator) {}
-        Owned(const Owned<List<T>>&) noexcept = default;
-        Owned(Owned<List<T>>&&) noexcept = default;
+        Owned(A& allocator) noexcept : IOwned<List<T, A>>(), allocator(allocator) {}
+        Owned(const Owned<List<T, A>>&) noexcept = default;
+        Owned(Owned<List<T, A>>&&) noexcept = default;
 
         // === Destructor ===
         ~Owned() {
@@ -145,15 +425,65 @@ namespace sk {
         }
 
         // === Associated Functions ===
-        List<T> clone() const noexcept {
+        List<T, A> clone() const noexcept {
             return this->as_ref().clone(allocator);
         }
 
         bool append(const T& item) noexcept {
             return this->as_ref().append(allocator, item);
         }
+
+        bool append(T&& item) noexcept {
+            return this->as_ref().append(allocator, std::move(item));
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args) noexcept {
+            return this->as_ref().emplace(allocator, std::forward<Args>(args)...);
+        }
+
+        bool reserve(size_t min_capacity) noexcept {
+            return this->as_ref().reserve(allocator, min_capacity);
+        }
+
+        bool extend(Array<T> items) noexcept {
+            return this->as_ref().extend(allocator, items);
+        }
+
+        bool append_n(size_t count, const T& value) noexcept {
+            return this->as_ref().append_n(allocator, count, value);
+        }
+
+        bool insert(Array<T> items, size_t at) noexcept {
+            return this->as_ref().insert(allocator, items, at);
+        }
+
+        void remove_range(size_t at, size_t count) noexcept {
+            this->as_ref().remove_range(at, count);
+        }
+
+        T swap_remove(size_t index) noexcept {
+            return this->as_ref().swap_remove(index);
+        }
+
+        bool resize(size_t new_len) noexcept {
+            return this->as_ref().resize(allocator, new_len);
+        }
+
+        bool append_nodes(size_t count) noexcept {
+            return this->as_ref().append_nodes(allocator, count);
+        }
+
+        void destroy_nodes() noexcept {
+            this->as_ref().destroy_nodes(allocator);
+        }
     };
 
-    template<typename T>
-    using OwnedList = Owned<List<T>>;
+    template<typename T, typename A = Allocator>
+    using OwnedList = Owned<List<T, A>>;
+
+    // An owned list is just the list plus a reference to its allocator, so
+    // lists of owned lists can grow with realloc too.
+    template<typename T, typename A>
+    struct is_trivially_relocatable<Owned<List<T, A>>> : std::true_type {};
 }
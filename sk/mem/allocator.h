@@ -1,16 +1,59 @@
 #pragma once
 
 #include <stdint.h>
+#include <new>
 
 #include "../optional.h"
 #include "../array.h"
 
 namespace sk {
+    // Largest alignment every allocator is required to honor. CAllocator and
+    // ArenaAllocator accept any power of two so they can back slab allocators.
+    inline constexpr uint32_t max_alignment = 4096;
+
+    namespace internal {
+        inline bool is_power_of_two(size_t n) noexcept {
+            return n != 0 && (n & (n - 1)) == 0;
+        }
+
+        inline uintptr_t align_forward(uintptr_t addr, size_t align) noexcept {
+            assert(is_power_of_two(align));
+            return (addr + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+        }
+    }
+
+    // An allocation may come back longer than requested when the allocator
+    // has room to spare. Whoever frees or resizes it must pass a length
+    // between the requested and the returned one; passing back what was
+    // returned keeps wrappers like TrackingAllocator exact. The typed helpers
+    // round the returned length down to whole items, which stays in range.
     struct Allocator {
         virtual Array<uint8_t> on_alloc(size_t size, uint32_t align) = 0;
         virtual Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) = 0;
         virtual void on_free(Array<uint8_t> buf, uint32_t buf_align) = 0;
 
+        // Makes `ptrs.len` separate allocations of `size` bytes each and writes
+        // them to `ptrs`. Either all succeed or none do. The allocations can be
+        // freed one by one or together with `on_free_batch`. Allocators that can
+        // carve many objects at once override these; the defaults just loop.
+        virtual bool on_alloc_batch(size_t size, uint32_t align, Array<uint8_t*> ptrs) {
+            for (size_t i = 0; i < ptrs.len; i++) {
+                auto allocation = this->on_alloc(size, align);
+                if (allocation.items == nullptr) {
+                    this->on_free_batch(Array{ i, ptrs.items }, size, align);
+                    return false;
+                }
+                ptrs[i] = allocation.items;
+            }
+            return true;
+        }
+
+        virtual void on_free_batch(Array<uint8_t*> ptrs, size_t size, uint32_t align) {
+            for (auto ptr : ptrs) {
+                this->on_free(Array{ size, ptr }, align);
+            }
+        }
+
         template<typename T>
         Array<T> alloc(size_t len, uint32_t align = 0) {
             uint32_t _align = align == 0 ? alignof(T) : align;
@@ -71,16 +114,37 @@ namespace sk {
             this->on_free(byte_buf, _align);
         }
 
+        template<typename T>
+        bool alloc_batch(Array<T *> ptrs, uint32_t align = 0) {
+            uint32_t _align = align == 0 ? alignof(T) : align;
+            auto byte_ptrs = Array{ ptrs.len, reinterpret_cast<uint8_t **>(ptrs.items) };
+            return this->on_alloc_batch(sizeof(T), _align, byte_ptrs);
+        }
+
+        template<typename T>
+        void free_batch(Array<T *> ptrs, uint32_t align = 0) {
+            uint32_t _align = align == 0 ? alignof(T) : align;
+            auto byte_ptrs = Array{ ptrs.len, reinterpret_cast<uint8_t **>(ptrs.items) };
+            this->on_free_batch(byte_ptrs, sizeof(T), _align);
+        }
+
         template<typename T>
         T *create(uint32_t align = 0) {
             uint32_t _align = align == 0 ? alignof(T) : align;
             auto allocation = this->on_alloc(sizeof(T), _align);
-            return reinterpret_cast<T *>(allocation.items);
+            if (allocation.items == nullptr) {
+                return nullptr;
+            }
+            return new (allocation.items) T{};
         }
 
         template<typename T>
-        void destroy(T *ptr) {
-            this->free(Array{ 1, ptr });
+        void destroy(T *ptr, uint32_t align = 0) {
+            if (ptr == nullptr) {
+                return;
+            }
+            ptr->~T();
+            this->free(Array{ 1, ptr }, align);
         }
     };
 }
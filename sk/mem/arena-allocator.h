@@ -5,7 +5,15 @@
 #include <stdint.h>
 
 namespace sk {
-    struct ArenaAllocator : Allocator {
+    // Controls how an ArenaAllocator sizes new blocks and how many blocks it
+    // keeps around for reuse after `reset()` or `rollback()`.
+    struct ArenaGrowthPolicy {
+        size_t growth_factor  = 1;        // each new block is the previous one times this
+        size_t max_block_size = 0;        // cap for geometric growth, 0 means uncapped
+        size_t max_retained   = SIZE_MAX; // bytes of free blocks kept for reuse
+    };
+
+    struct ArenaAllocator final : Allocator {
         // === Structures ===
         struct MemoryBlock {
             MemoryBlock* next;
@@ -21,13 +29,18 @@ namespace sk {
 
         // === Data ===
         MemoryBlock* _blocks;
+        MemoryBlock* _free_blocks;
+        size_t _retained;
+        size_t _next_block_size;
         size_t block_size;
+        ArenaGrowthPolicy policy;
         Allocator* ator;
 
         // === Constructors / Assignments ===
         ArenaAllocator() noexcept = default;
         ArenaAllocator(Allocator* allocator) noexcept;
         ArenaAllocator(Allocator* allocator, size_t block_size) noexcept;
+        ArenaAllocator(Allocator* allocator, size_t block_size, ArenaGrowthPolicy policy) noexcept;
         ArenaAllocator(const ArenaAllocator&) noexcept = default;
         ArenaAllocator(ArenaAllocator&&) noexcept = default;
 
@@ -36,14 +49,102 @@ namespace sk {
 
         // === Associated Functions ===
         static size_t _memory_block_allocation_size(size_t memory_size);
+        static bool _fits(const MemoryBlock* block, size_t size, uint32_t align) noexcept;
         MemoryBlock* _make_block(size_t size) const noexcept;
+        MemoryBlock* _acquire_block(size_t min_size) noexcept;
+        void _release_block(MemoryBlock* block) noexcept;
+        void _retire_block(MemoryBlock* block) noexcept;
         Mark mark() const noexcept;
         bool rollback(Mark mark) noexcept;
+        void reset() noexcept;
         void destroy() noexcept;
 
+        // === Static Dispatch ===
+        // These shadow Allocator's helpers so code holding an ArenaAllocator
+        // directly (e.g. List<T, ArenaAllocator>) bumps inline and only makes
+        // a non-virtual call when a new block is needed.
+        uint8_t* _try_bump(size_t size, uint32_t align) noexcept {
+            auto block = this->_blocks;
+            if (block == nullptr) {
+                return nullptr;
+            }
+
+            auto memory_start = reinterpret_cast<uintptr_t>(block->memory);
+            auto aligned_start = internal::align_forward(memory_start + block->allocated, align);
+            auto end = aligned_start - memory_start + size;
+            if (end > block->size) {
+                return nullptr;
+            }
+
+            block->allocated = end;
+            return reinterpret_cast<uint8_t*>(aligned_start);
+        }
+
+        template<typename T>
+        Array<T> alloc(size_t len, uint32_t align = 0) {
+            uint32_t _align = align == 0 ? alignof(T) : align;
+            auto ptr = this->_try_bump(len * sizeof(T), _align);
+            if (ptr == nullptr) {
+                auto raw_allocation = this->ArenaAllocator::on_alloc(len * sizeof(T), _align);
+                if (raw_allocation.items == nullptr) {
+                    return { 0, nullptr };
+                }
+                ptr = raw_allocation.items;
+            }
+            return { len, reinterpret_cast<T*>(ptr) };
+        }
+
+        template<typename T>
+        Optional<T *> resize(size_t old_len, T *ptr, size_t new_len, uint32_t align = 0) {
+            auto new_buf = this->resize(Array{ old_len, ptr }, new_len, align);
+            if (new_buf.is_none()) {
+                return None;
+            }
+
+            return new_buf.unwrap().items;
+        }
+
+        template<typename T>
+        Optional<Array<T>> resize(Array<T> buf, size_t new_len, uint32_t align = 0) {
+            // Growing or shrinking the last allocation within its block is
+            // the common case for List growth
+            auto block = this->_blocks;
+            auto items = reinterpret_cast<uint8_t*>(buf.items);
+            if (block && items && items + buf.len * sizeof(T) == &block->memory[block->allocated]) {
+                auto offset = static_cast<size_t>(items - block->memory);
+                if (offset + new_len * sizeof(T) <= block->size) {
+                    block->allocated = offset + new_len * sizeof(T);
+                    buf.len = new_len;
+                    return buf;
+                }
+            }
+
+            uint32_t _align = align == 0 ? alignof(T) : align;
+            auto byte_buf = Array<uint8_t>{ buf.len * sizeof(T), items };
+            auto opt_byte_buf = this->ArenaAllocator::on_resize(byte_buf, _align, new_len * sizeof(T));
+            if (opt_byte_buf.is_none()) {
+                return None;
+            }
+
+            auto new_byte_buf = opt_byte_buf.unwrap();
+            return Array{ new_byte_buf.len / sizeof(T), reinterpret_cast<T*>(new_byte_buf.items) };
+        }
+
+        template<typename T>
+        void free(size_t len, T *ptr, uint32_t align = 0) {
+            // Nothing to do, see `on_free`
+        }
+
+        template<typename T>
+        void free(Array<T> buf, uint32_t buf_align = 0) {
+            // Nothing to do, see `on_free`
+        }
+
         // === Inherited Functions ===
         Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
         Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
         void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+        bool on_alloc_batch(size_t size, uint32_t align, Array<uint8_t*> ptrs) override;
+        void on_free_batch(Array<uint8_t*> ptrs, size_t size, uint32_t align) override;
     };
 }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "allocator.h"
+#include "../fmt.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sk {
+    struct BuddyStats {
+        size_t total_bytes;
+        size_t free_bytes;
+        size_t largest_free_block;
+        size_t free_blocks;
+
+        // 0 when all free memory is one block, approaching 1 as it splinters.
+        double fragmentation() const noexcept;
+    };
+
+    // Power-of-two buddy allocator over one region taken from an upstream
+    // allocator. Requests are rounded up to a power of two, blocks are split
+    // in halves to get there, and a freed block merges with its buddy whenever
+    // the buddy is free too, so both split and coalesce are O(log n).
+    //
+    // Blocks are aligned to their own size relative to the region, and the
+    // region itself is page aligned.
+    struct BuddyAllocator : Allocator {
+        // === Structures ===
+        static constexpr size_t max_orders = 48;
+
+        struct FreeBlock {
+            FreeBlock* prev;
+            FreeBlock* next;
+        };
+
+        // === Data ===
+        uint8_t* _base;
+        uint8_t* _free_order; // per minimum block, order + 1 when a free block starts there
+        FreeBlock* _free_lists[max_orders];
+        size_t _free_counts[max_orders];
+        size_t min_order;
+        size_t max_order;
+        Allocator* ator;
+
+        // === Constructors / Assignments ===
+        BuddyAllocator() noexcept = default;
+        BuddyAllocator(const BuddyAllocator&) noexcept = default;
+        BuddyAllocator(BuddyAllocator&&) noexcept = default;
+
+        BuddyAllocator& operator=(const BuddyAllocator&) noexcept = default;
+        BuddyAllocator& operator=(BuddyAllocator&&) noexcept = default;
+
+        // `region_size` and `min_block_size` are rounded up to powers of two.
+        static Optional<BuddyAllocator> make(Allocator* allocator, size_t region_size, size_t min_block_size = 64) noexcept;
+
+        // === Associated Functions ===
+        size_t _order_for(size_t size, uint32_t align) const noexcept;
+        size_t _index_of(size_t offset) const noexcept;
+        void _push(size_t offset, size_t order) noexcept;
+        void _remove(size_t offset, size_t order) noexcept;
+        bool _is_free(size_t offset, size_t order) const noexcept;
+        void _release(size_t offset, size_t order) noexcept;
+        BuddyStats stats() const noexcept;
+        void destroy() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+
+    template<> struct Formatter<BuddyStats> {
+        static void format(const BuddyStats& stats, std::string_view fmt, Writer& writer);
+    };
+}
@@ -3,10 +3,18 @@
 #include "allocator.h"
 
 namespace sk {
+    namespace internal {
+        // How many bytes the malloc'd `allocation` can really hold, or
+        // `requested` where the C library can't tell us.
+        size_t malloc_usable_size(void* allocation, size_t requested) noexcept;
+    }
+
     struct CAllocator : Allocator {
         Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
         Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
         void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+        bool on_alloc_batch(size_t size, uint32_t align, Array<uint8_t*> ptrs) override;
+        void on_free_batch(Array<uint8_t*> ptrs, size_t size, uint32_t align) override;
     };
 
     inline CAllocator c_allocator;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "allocator.h"
+
+#include <stdint.h>
+#include <atomic>
+
+namespace sk {
+    // Arena that many threads can allocate from at once. Allocation is a single
+    // fetch-add on the current block and a full block is replaced with a
+    // compare-and-swap, so there are no locks anywhere on the allocation path.
+    //
+    // The upstream allocator must itself be thread-safe. `destroy()` must only
+    // be called once every thread is done with the arena.
+    struct ConcurrentArenaAllocator : Allocator {
+        // === Structures ===
+        struct MemoryBlock {
+            MemoryBlock* next;
+            std::atomic<size_t> allocated;
+            size_t size;
+            alignas(16) uint8_t memory[1];
+        };
+
+        // === Constants ===
+        // Every reservation is rounded to this so block offsets stay aligned
+        // for any type without extra padding.
+        static constexpr size_t granularity = 16;
+
+        // === Data ===
+        std::atomic<MemoryBlock*> _current;
+        std::atomic<MemoryBlock*> _oversized;
+        size_t block_size;
+        Allocator* ator;
+
+        // === Constructors / Assignments ===
+        ConcurrentArenaAllocator(Allocator* allocator, size_t block_size) noexcept;
+        ConcurrentArenaAllocator(const ConcurrentArenaAllocator&) = delete;
+        ConcurrentArenaAllocator(ConcurrentArenaAllocator&&) = delete;
+
+        ConcurrentArenaAllocator& operator=(const ConcurrentArenaAllocator&) = delete;
+        ConcurrentArenaAllocator& operator=(ConcurrentArenaAllocator&&) = delete;
+
+        // === Associated Functions ===
+        static size_t _memory_block_allocation_size(size_t memory_size);
+        static size_t _reservation_size(size_t size, uint32_t align) noexcept;
+        MemoryBlock* _make_block(size_t size, size_t reserved) const noexcept;
+        void _release_block(MemoryBlock* block) const noexcept;
+        void destroy() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
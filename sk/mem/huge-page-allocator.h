@@ -0,0 +1,86 @@
+#pragma once
+
+#include "allocator.h"
+#include "../list.h"
+#include "../fmt.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+
+namespace sk {
+    enum struct HugePageBacking : uint8_t {
+        Regular,     // small pages only, huge pages were unavailable
+        HugeTLB,     // MAP_HUGETLB, backed by reserved huge pages up front
+        Transparent, // MADV_HUGEPAGE, the kernel may back it with huge pages as it is touched
+    };
+
+    struct HugePageInfo {
+        uint8_t* address;
+        size_t mapped_size;
+        HugePageBacking backing;
+        size_t huge_bytes; // bytes actually backed by huge pages when queried
+    };
+
+    // Serves requests of at least `threshold` bytes from their own 2 MiB aligned
+    // mappings backed by huge pages, so full-frame passes over large canvases
+    // and buffers take far fewer TLB misses. MAP_HUGETLB is tried first, then a
+    // regular mapping advised with MADV_HUGEPAGE; whatever the kernel grants,
+    // the allocation still succeeds. Smaller requests go to `ator`. Off Linux
+    // only the aligned regular mapping is made and it reports Regular.
+    //
+    // Mappings are rounded up to whole huge pages, so keep `threshold` well
+    // above the huge page size when memory overhead matters.
+    struct HugePageAllocator : Allocator {
+        // === Structures ===
+        static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+        struct Mapping {
+            uint8_t* base;
+            size_t size;
+            HugePageBacking backing;
+        };
+
+        // === Data ===
+        Allocator* ator;
+        size_t threshold;
+        bool try_hugetlb;
+        std::mutex _lock;
+        List<Mapping> _mappings;
+
+        // === Constructors / Assignments ===
+        HugePageAllocator(Allocator* allocator, size_t threshold = huge_page_size, bool try_hugetlb = true) noexcept;
+        HugePageAllocator(const HugePageAllocator&) = delete;
+        HugePageAllocator(HugePageAllocator&&) = delete;
+
+        HugePageAllocator& operator=(const HugePageAllocator&) = delete;
+        HugePageAllocator& operator=(HugePageAllocator&&) = delete;
+
+        ~HugePageAllocator() noexcept;
+
+        // === Associated Functions ===
+        Optional<Mapping> _map(size_t size, uint32_t align) noexcept;
+        size_t _find(const uint8_t* ptr) noexcept;
+        bool _unmap(const uint8_t* ptr) noexcept;
+
+        // Reports how the allocation containing `ptr` is backed, or None if it
+        // was not served from a huge page mapping.
+        Optional<HugePageInfo> query(const void* ptr) noexcept;
+
+        // Writes one line per live huge page mapping.
+        void write_report(Writer& writer) noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+
+    template<> struct Formatter<HugePageBacking> {
+        static void format(const HugePageBacking& backing, std::string_view fmt, Writer& writer);
+    };
+
+    template<> struct Formatter<HugePageInfo> {
+        static void format(const HugePageInfo& info, std::string_view fmt, Writer& writer);
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "allocator.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sk {
+    // Bump allocator whose memory is a file mapped at a fixed address. Because
+    // every reopen maps the file at the same base, pointers stored inside it stay
+    // valid, so a List<T> or Array<T> of plain data built here can be flushed and
+    // picked up by a later process without any parsing. The allocation cursor
+    // and a root offset live in the file header; `root()` is how a reopening
+    // process finds its data again.
+    //
+    // Only trivially copyable data should be stored, and nothing pointing
+    // outside the arena.
+    struct PersistentArenaAllocator : Allocator {
+        // === Structures ===
+        static constexpr uint64_t magic = 0x00414e4552414b53; // "SKARENA\0" in little endian
+        static constexpr uint32_t version = 1;
+        static constexpr uintptr_t default_base = 0x200000000000;
+
+        struct Header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t _reserved;
+            uint64_t base;
+            uint64_t capacity;
+            uint64_t allocated; // offset of the first unused byte, including the header
+            uint64_t root;      // offset of the root object, 0 when unset
+        };
+
+        struct Mark {
+            size_t _index;
+        };
+
+        // === Data ===
+        Header* _header;
+        int _fd;
+        bool created; // true when the file did not exist or was empty
+
+        // === Constructors / Assignments ===
+        PersistentArenaAllocator() noexcept = default;
+        PersistentArenaAllocator(const PersistentArenaAllocator&) noexcept = default;
+        PersistentArenaAllocator(PersistentArenaAllocator&&) noexcept = default;
+
+        PersistentArenaAllocator& operator=(const PersistentArenaAllocator&) noexcept = default;
+        PersistentArenaAllocator& operator=(PersistentArenaAllocator&&) noexcept = default;
+
+        // Opens or creates the arena file at `path`. A new file is sized to
+        // `capacity` (sparsely); an existing one keeps the capacity it was made
+        // with. Fails if the file is not an arena, or if `base` is already in use
+        // in this process.
+        static Optional<PersistentArenaAllocator> open(const char* path, size_t capacity, uintptr_t base = default_base) noexcept;
+
+        // === Associated Functions ===
+        uint8_t* _base() const noexcept;
+
+        template<typename T>
+        T* root() const noexcept {
+            if (this->_header->root == 0) {
+                return nullptr;
+            }
+            return reinterpret_cast<T*>(this->_base() + this->_header->root);
+        }
+
+        void set_root(const void* root) noexcept;
+
+        Mark mark() const noexcept;
+        bool rollback(Mark mark) noexcept;
+        void reset() noexcept;
+
+        size_t allocated() const noexcept;
+        size_t capacity() const noexcept;
+
+        // Writes dirty pages back to the file and waits for them.
+        bool flush() noexcept;
+
+        // Unmaps the file. Data reaches the file even without `flush()`, but
+        // only `flush()` guarantees it is on disk.
+        void close() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
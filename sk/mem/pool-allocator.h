@@ -0,0 +1,66 @@
+#pragma once
+
+#include "allocator.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sk {
+    // Hands out fixed-size slots carved from slabs of an upstream allocator.
+    // Slabs are aligned to their own size so the owning slab of any slot is
+    // found by masking its address, which means slots carry no header at all.
+    struct PoolAllocator : Allocator {
+        // === Structures ===
+        struct Slot {
+            Slot* next;
+        };
+
+        struct Slab {
+            Slab* prev;
+            Slab* next;
+            Slot* free_slots;
+            size_t used;
+            size_t carved;
+        };
+
+        // === Data ===
+        Slab* _partial;
+        Slab* _full;
+        Slab* _empty;
+        size_t slot_size;
+        uint32_t slot_align;
+        size_t slab_size;
+        size_t slots_per_slab;
+        Allocator* ator;
+
+        // === Constructors / Assignments ===
+        PoolAllocator() noexcept = default;
+        PoolAllocator(Allocator* allocator, size_t slot_size, uint32_t slot_align, size_t slab_size = 64 * 1024) noexcept;
+        PoolAllocator(const PoolAllocator&) noexcept = default;
+        PoolAllocator(PoolAllocator&&) noexcept = default;
+
+        PoolAllocator& operator=(const PoolAllocator&) noexcept = default;
+        PoolAllocator& operator=(PoolAllocator&&) noexcept = default;
+
+        template<typename T>
+        static PoolAllocator make(Allocator* allocator, size_t slab_size = 64 * 1024) noexcept {
+            return PoolAllocator{ allocator, sizeof(T), alignof(T), slab_size };
+        }
+
+        // === Associated Functions ===
+        using Allocator::destroy;
+
+        size_t _first_slot_offset() const noexcept;
+        Slab* _slab_of(const void* ptr) const noexcept;
+        Slab* _make_slab() noexcept;
+        void _release_slab(Slab* slab) noexcept;
+        static void _link(Slab** list, Slab* slab) noexcept;
+        static void _unlink(Slab** list, Slab* slab) noexcept;
+        void destroy() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "allocator.h"
+#include "../list.h"
+#include "../fmt.h"
+
+#include <stdint.h>
+#include <mutex>
+
+namespace sk {
+    // Sampling heap profiler layered on any allocator. Roughly every
+    // `sample_interval` bytes allocated on a thread, the call stack of the
+    // allocation is captured and charged with the bytes it stands for. Stacks
+    // are only symbolized when the profile is written out, in the folded format
+    // flamegraph tooling reads ("outer;inner;leaf bytes").
+    //
+    // Sampling state is thread-local and shared between profilers.
+    struct ProfilingAllocator : Allocator {
+        // === Structures ===
+        static constexpr size_t max_frames = 32;
+
+        struct StackRecord {
+            uint64_t hash;
+            size_t frame_count;
+            void* frames[max_frames];
+            size_t samples;
+            size_t bytes;
+        };
+
+        // === Data ===
+        Allocator* ator;
+        size_t sample_interval;
+        std::mutex _lock;
+        List<StackRecord> _stacks;
+
+        // === Constructors / Assignments ===
+        ProfilingAllocator(Allocator* allocator, size_t sample_interval = 512 * 1024) noexcept;
+        ProfilingAllocator(const ProfilingAllocator&) = delete;
+        ProfilingAllocator(ProfilingAllocator&&) = delete;
+
+        ProfilingAllocator& operator=(const ProfilingAllocator&) = delete;
+        ProfilingAllocator& operator=(ProfilingAllocator&&) = delete;
+
+        ~ProfilingAllocator() noexcept;
+
+        // === Associated Functions ===
+        void _account(size_t size) noexcept;
+        void _record_sample(size_t bytes) noexcept;
+        size_t sampled_bytes() noexcept;
+        void write_folded(Writer& writer) noexcept;
+        void clear() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sk {
+    // A type is trivially relocatable when moving an object to a new address
+    // and ending its lifetime at the old one is the same as copying its bytes.
+    // Containers use this to grow with memcpy/realloc instead of moving every
+    // element one by one. Trivially copyable types qualify automatically; other
+    // types that own memory through plain pointers (and do not point into
+    // themselves) can opt in by specializing this.
+    template<typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // Moves `len` objects from `src` into uninitialized memory at `dst`, leaving
+    // `src` as uninitialized memory. The ranges must not overlap.
+    template<typename T>
+    void relocate(T* dst, T* src, size_t len) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (len > 0) {
+                memcpy(static_cast<void*>(dst), static_cast<const void*>(src), len * sizeof(T));
+            }
+        } else {
+            for (size_t i = 0; i < len; i++) {
+                new (&dst[i]) T(std::move(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+
+    // Ends the lifetime of `len` objects, doing nothing for trivial types.
+    template<typename T>
+    void destroy_range(T* items, size_t len) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < len; i++) {
+                items[i].~T();
+            }
+        }
+    }
+}
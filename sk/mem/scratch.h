@@ -0,0 +1,43 @@
+#pragma once
+
+#include "arena-allocator.h"
+
+namespace sk {
+    // Scoped view of one of the calling thread's scratch arenas. Everything
+    // allocated through it is rewound when the scope ends, so temporary memory
+    // never has to be freed by hand.
+    struct Scratch {
+        // === Data ===
+        ArenaAllocator& arena;
+        ArenaAllocator::Mark _mark;
+
+        // === Constructors / Destructors ===
+        Scratch(ArenaAllocator& arena) noexcept;
+        Scratch(const Scratch&) = delete;
+        Scratch(Scratch&&) = delete;
+
+        Scratch& operator=(const Scratch&) = delete;
+        Scratch& operator=(Scratch&&) = delete;
+
+        ~Scratch() noexcept;
+
+        // === Conversions ===
+        operator Allocator&() noexcept {
+            return this->arena;
+        }
+
+        // === Associated Functions ===
+        template<typename T>
+        Array<T> alloc(size_t len, uint32_t align = 0) {
+            return this->arena.alloc<T>(len, align);
+        }
+    };
+
+    // Returns a scope over a thread-local scratch arena that is not `conflict`.
+    //
+    // A function that takes an allocator for its result and also wants
+    // temporary memory should pass that allocator as `conflict`. If the caller
+    // handed in its own scratch arena, the function then gets the other one and
+    // rewinding its scope cannot free the result.
+    Scratch scratch(const Allocator* conflict = nullptr) noexcept;
+}
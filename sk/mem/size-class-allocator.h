@@ -0,0 +1,54 @@
+#pragma once
+
+#include "allocator.h"
+#include "../fmt.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sk {
+    struct SizeClassStats {
+        size_t size;     // object size served by this class
+        size_t allocs;   // allocations reported by thread caches so far
+        size_t frees;    // frees reported by thread caches so far
+        size_t refills;  // batches moved from the central heap to a thread cache
+        size_t flushes;  // batches moved from a thread cache back to the central heap
+        size_t spans;    // spans carved from the system for this class
+        size_t central;  // objects currently parked in the central heap
+    };
+
+    // General purpose allocator that rounds small requests up to one of a fixed
+    // set of size classes. Each thread keeps a cache of free objects per class
+    // and only takes the central heap's lock to move a whole batch in or out, so
+    // threads allocating and freeing in steady state never contend.
+    //
+    // Requests above `max_small_size` or aligned past 16 bytes go straight to
+    // the C allocator. Spans carved for small classes are never returned to the
+    // system, only recycled between threads.
+    struct SizeClassAllocator : Allocator {
+        // === Constants ===
+        static constexpr size_t class_count = 40;
+        static constexpr size_t min_align = 16;
+        static constexpr size_t max_small_size = 32 * 1024;
+
+        // === Associated Functions ===
+        static bool is_small(size_t size, uint32_t align) noexcept;
+        static size_t class_of(size_t size) noexcept;
+        static size_t class_size(size_t index) noexcept;
+        static SizeClassStats stats(size_t index) noexcept;
+
+        // Returns every object cached by the calling thread to the central heap.
+        static void flush_thread_cache() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+
+    inline SizeClassAllocator size_class_allocator;
+
+    template<> struct Formatter<SizeClassStats> {
+        static void format(const SizeClassStats& stats, std::string_view fmt, Writer& writer);
+    };
+}
@@ -1,16 +1,25 @@
 #include "../arena-allocator.h"
 
+#include <string.h>
+
 namespace sk {
     ArenaAllocator::ArenaAllocator(Allocator* allocator) noexcept :
-        _blocks(nullptr),
-        block_size(0),
-        ator(allocator)
+        ArenaAllocator(allocator, 0)
     {
     }
 
     ArenaAllocator::ArenaAllocator(Allocator* allocator, size_t block_size) noexcept :
+        ArenaAllocator(allocator, block_size, ArenaGrowthPolicy{})
+    {
+    }
+
+    ArenaAllocator::ArenaAllocator(Allocator* allocator, size_t block_size, ArenaGrowthPolicy policy) noexcept :
         _blocks(nullptr),
+        _free_blocks(nullptr),
+        _retained(0),
+        _next_block_size(block_size),
         block_size(block_size),
+        policy(policy),
         ator(allocator)
     {
     }
@@ -21,8 +30,11 @@ namespace sk {
     
     ArenaAllocator::MemoryBlock* ArenaAllocator::_make_block(size_t size) const noexcept {
         auto allocation_size = ArenaAllocator::_memory_block_allocation_size(size);
-        auto block_allocation = this->ator->alloc<uint8_t>(allocation_size);
+        auto block_allocation = this->ator->alloc<uint8_t>(allocation_size, alignof(MemoryBlock));
         auto block = reinterpret_cast<MemoryBlock*>(block_allocation.items);
+        if (block == nullptr) {
+            return nullptr;
+        }
 
         block->next = nullptr;
         block->allocated = 0;
@@ -31,6 +43,55 @@ namespace sk {
         return block;
     }
 
+    ArenaAllocator::MemoryBlock* ArenaAllocator::_acquire_block(size_t min_size) noexcept {
+        // Recycled blocks come first so a warmed up arena never goes upstream.
+        for (auto link = &this->_free_blocks; *link != nullptr; link = &(*link)->next) {
+            auto block = *link;
+            if (block->size >= min_size) {
+                *link = block->next;
+                this->_retained -= block->size;
+
+                block->next = nullptr;
+                block->allocated = 0;
+                return block;
+            }
+        }
+
+        auto size = min_size > this->_next_block_size ? min_size : this->_next_block_size;
+        auto block = this->_make_block(size);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        if (this->policy.growth_factor > 1) {
+            auto next_size = this->_next_block_size * this->policy.growth_factor;
+            if (this->policy.max_block_size != 0 && next_size > this->policy.max_block_size) {
+                next_size = this->policy.max_block_size;
+            }
+            if (next_size > this->_next_block_size) {
+                this->_next_block_size = next_size;
+            }
+        }
+
+        return block;
+    }
+
+    void ArenaAllocator::_release_block(MemoryBlock* block) noexcept {
+        auto allocation_size = ArenaAllocator::_memory_block_allocation_size(block->size);
+        this->ator->free(allocation_size, reinterpret_cast<uint8_t*>(block), alignof(MemoryBlock));
+    }
+
+    void ArenaAllocator::_retire_block(MemoryBlock* block) noexcept {
+        if (this->_retained + block->size > this->policy.max_retained) {
+            this->_release_block(block);
+            return;
+        }
+
+        this->_retained += block->size;
+        block->next = this->_free_blocks;
+        this->_free_blocks = block;
+    }
+
     ArenaAllocator::Mark ArenaAllocator::mark() const noexcept {
         if (this->_blocks == nullptr) {
             return { 0, nullptr };
@@ -41,20 +102,18 @@ namespace sk {
 
     bool ArenaAllocator::rollback(Mark mark) noexcept {
         if (mark._block == nullptr) {
-            this->destroy();
+            this->reset();
             return true;
         }
 
         auto it = this->_blocks;
         while (it && it != mark._block) {
             auto next = it->next;
-
-            auto allocation_size = ArenaAllocator::_memory_block_allocation_size(it->size);
-            this->ator->free(allocation_size, reinterpret_cast<uint8_t*>(it));
-
+            this->_retire_block(it);
             it = next;
         }
 
+        this->_blocks = it;
         if (it) {
             it->allocated = mark._index;
         }
@@ -62,58 +121,88 @@ namespace sk {
         return true;
     }
 
-    void ArenaAllocator::destroy() noexcept {
+    void ArenaAllocator::reset() noexcept {
         auto it = this->_blocks;
         while (it != nullptr) {
             auto next = it->next;
+            this->_retire_block(it);
+            it = next;
+        }
+
+        this->_blocks = nullptr;
+    }
 
-            auto allocation_size = ArenaAllocator::_memory_block_allocation_size(it->size);
-            this->ator->free(allocation_size, reinterpret_cast<uint8_t*>(it));
+    void ArenaAllocator::destroy() noexcept {
+        this->reset();
 
+        auto it = this->_free_blocks;
+        while (it != nullptr) {
+            auto next = it->next;
+            this->_release_block(it);
             it = next;
         }
+
+        this->_free_blocks = nullptr;
+        this->_retained = 0;
+    }
+
+    bool ArenaAllocator::_fits(const MemoryBlock* block, size_t size, uint32_t align) noexcept {
+        auto memory_start = reinterpret_cast<uintptr_t>(block->memory);
+        auto aligned_start = internal::align_forward(memory_start + block->allocated, align);
+        return aligned_start - memory_start + size <= block->size;
     }
 
     Array<uint8_t> ArenaAllocator::on_alloc(size_t size, uint32_t align) {
-        // @TODO:
-        // Handle alignment
-        // 
+        assert(internal::is_power_of_two(align));
+
+        auto block = this->_blocks;
+        if (!block || !ArenaAllocator::_fits(block, size, align)) {
+            // Reserve enough for the worst-case padding so the request fits
+            // regardless of how the upstream allocator aligned the block.
+            auto new_block_size = size + align - 1;
+            block = this->_acquire_block(new_block_size);
+            if (block == nullptr) {
+                return { 0, nullptr };
+            }
 
-        if (size > this->block_size) {
-            auto block = ArenaAllocator::_make_block(size);
-            block->next = this->_blocks;
-            this->_blocks = block;
-        } else if (!this->_blocks || size + this->_blocks->allocated > this->_blocks->size) {
-            auto block = ArenaAllocator::_make_block(this->block_size);
             block->next = this->_blocks;
             this->_blocks = block;
         }
 
-        auto block = this->_blocks;
-        auto ptr = &block->memory[block->allocated];
-        block->allocated += size;
+        auto memory_start = reinterpret_cast<uintptr_t>(block->memory);
+        auto aligned_start = internal::align_forward(memory_start + block->allocated, align);
+        block->allocated = aligned_start - memory_start + size;
 
-        return { size, ptr };
+        return { size, reinterpret_cast<uint8_t*>(aligned_start) };
     }
 
     Optional<Array<uint8_t>> ArenaAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
         auto block = this->_blocks;
-        
-        if (block && new_size <= this->block_size) {
-            auto memory_start = (uintptr_t)block->memory;
-            auto free_memory_start = memory_start + block->allocated;
-            auto last_allocation = free_memory_start - buf.len;
-            auto this_allocation = (uintptr_t)buf.items;
-            if (last_allocation == this_allocation) {
-                auto size_difference = new_size - buf.len;
-                block->allocated += size_difference;
+
+        // The most recent allocation can grow or shrink in place as long as it
+        // stays within its block. Its address, and so its alignment, is unchanged.
+        if (block && buf.items && buf.items + buf.len == &block->memory[block->allocated]) {
+            auto offset = static_cast<size_t>(buf.items - block->memory);
+            if (offset + new_size <= block->size) {
+                block->allocated = offset + new_size;
                 buf.len = new_size;
                 return buf;
             }
         }
 
+        if (new_size <= buf.len) {
+            buf.len = new_size;
+            return buf;
+        }
+
         auto new_allocation = this->on_alloc(new_size, buf_align);
-        memcpy(new_allocation.items, buf.items, buf.len);
+        if (new_allocation.items == nullptr) {
+            return None;
+        }
+
+        if (buf.len > 0) {
+            memcpy(new_allocation.items, buf.items, buf.len);
+        }
 
         return new_allocation;
     }
@@ -121,4 +210,31 @@ namespace sk {
     void ArenaAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
         // We do nothing because ArenaAllocator is a dump-it-all-together type of allocator
     }
+
+    bool ArenaAllocator::on_alloc_batch(size_t size, uint32_t align, Array<uint8_t*> ptrs) {
+        if (ptrs.len == 0) {
+            return true;
+        }
+
+        // One bump for the whole batch, carved into aligned slots.
+        auto stride = internal::align_forward(size > 0 ? size : 1, align);
+        if (stride * ptrs.len / ptrs.len != stride) {
+            return false;
+        }
+
+        auto allocation = this->ArenaAllocator::on_alloc(stride * ptrs.len, align);
+        if (allocation.items == nullptr) {
+            return false;
+        }
+
+        for (size_t i = 0; i < ptrs.len; i++) {
+            ptrs[i] = allocation.items + i * stride;
+        }
+
+        return true;
+    }
+
+    void ArenaAllocator::on_free_batch(Array<uint8_t*> ptrs, size_t size, uint32_t align) {
+        // Nothing to do, see `on_free`
+    }
 }
@@ -0,0 +1,243 @@
+#include "../buddy-allocator.h"
+
+#include <string.h>
+
+namespace sk {
+    namespace {
+        constexpr size_t region_alignment = 4096;
+
+        size_t ceil_log2(size_t n) {
+            return n <= 1 ? 0 : 64 - __builtin_clzll(n - 1);
+        }
+    }
+
+    double BuddyStats::fragmentation() const noexcept {
+        if (this->free_bytes == 0) {
+            return 0.0;
+        }
+        return 1.0 - static_cast<double>(this->largest_free_block) / static_cast<double>(this->free_bytes);
+    }
+
+    Optional<BuddyAllocator> BuddyAllocator::make(Allocator* allocator, size_t region_size, size_t min_block_size) noexcept {
+        BuddyAllocator buddy;
+        buddy.ator = allocator;
+        buddy.min_order = ceil_log2(min_block_size > sizeof(FreeBlock) ? min_block_size : sizeof(FreeBlock));
+        buddy.max_order = ceil_log2(region_size);
+        if (buddy.max_order < buddy.min_order) {
+            buddy.max_order = buddy.min_order;
+        }
+        if (buddy.max_order >= max_orders) {
+            return None;
+        }
+
+        auto size = size_t{ 1 } << buddy.max_order;
+        auto align = size < region_alignment ? size : region_alignment;
+        auto region = allocator->alloc<uint8_t>(size, static_cast<uint32_t>(align));
+        if (region.items == nullptr) {
+            return None;
+        }
+
+        auto map_len = size_t{ 1 } << (buddy.max_order - buddy.min_order);
+        auto map = allocator->alloc<uint8_t>(map_len);
+        if (map.items == nullptr) {
+            allocator->free(region, static_cast<uint32_t>(align));
+            return None;
+        }
+
+        memset(map.items, 0, map_len);
+        memset(buddy._free_lists, 0, sizeof(buddy._free_lists));
+        memset(buddy._free_counts, 0, sizeof(buddy._free_counts));
+        buddy._base = region.items;
+        buddy._free_order = map.items;
+        buddy._push(0, buddy.max_order);
+
+        return buddy;
+    }
+
+    size_t BuddyAllocator::_order_for(size_t size, uint32_t align) const noexcept {
+        // A block is aligned to its own size so over-aligned requests just
+        // take a bigger block.
+        auto order = ceil_log2(size > align ? size : align);
+        return order < this->min_order ? this->min_order : order;
+    }
+
+    size_t BuddyAllocator::_index_of(size_t offset) const noexcept {
+        return offset >> this->min_order;
+    }
+
+    void BuddyAllocator::_push(size_t offset, size_t order) noexcept {
+        auto block = reinterpret_cast<FreeBlock*>(this->_base + offset);
+        block->prev = nullptr;
+        block->next = this->_free_lists[order];
+        if (block->next) {
+            block->next->prev = block;
+        }
+
+        this->_free_lists[order] = block;
+        this->_free_counts[order]++;
+        this->_free_order[this->_index_of(offset)] = static_cast<uint8_t>(order + 1);
+    }
+
+    void BuddyAllocator::_remove(size_t offset, size_t order) noexcept {
+        auto block = reinterpret_cast<FreeBlock*>(this->_base + offset);
+        if (block->prev) {
+            block->prev->next = block->next;
+        } else {
+            this->_free_lists[order] = block->next;
+        }
+
+        if (block->next) {
+            block->next->prev = block->prev;
+        }
+
+        this->_free_counts[order]--;
+        this->_free_order[this->_index_of(offset)] = 0;
+    }
+
+    bool BuddyAllocator::_is_free(size_t offset, size_t order) const noexcept {
+        return this->_free_order[this->_index_of(offset)] == order + 1;
+    }
+
+    void BuddyAllocator::_release(size_t offset, size_t order) noexcept {
+        // Merge upwards for as long as the buddy is a free block of the same size
+        while (order < this->max_order) {
+            auto buddy = offset ^ (size_t{ 1 } << order);
+            if (!this->_is_free(buddy, order)) {
+                break;
+            }
+
+            this->_remove(buddy, order);
+            offset = offset < buddy ? offset : buddy;
+            order++;
+        }
+
+        this->_push(offset, order);
+    }
+
+    BuddyStats BuddyAllocator::stats() const noexcept {
+        BuddyStats stats = {};
+        stats.total_bytes = size_t{ 1 } << this->max_order;
+
+        for (size_t order = this->min_order; order <= this->max_order; order++) {
+            auto count = this->_free_counts[order];
+            if (count == 0) {
+                continue;
+            }
+
+            stats.free_blocks += count;
+            stats.free_bytes += count << order;
+            stats.largest_free_block = size_t{ 1 } << order;
+        }
+
+        return stats;
+    }
+
+    void BuddyAllocator::destroy() noexcept {
+        if (this->_base == nullptr) {
+            return;
+        }
+
+        auto size = size_t{ 1 } << this->max_order;
+        auto align = size < region_alignment ? size : region_alignment;
+        this->ator->free(size, this->_base, static_cast<uint32_t>(align));
+        this->ator->free(size_t{ 1 } << (this->max_order - this->min_order), this->_free_order);
+
+        this->_base = nullptr;
+        this->_free_order = nullptr;
+    }
+
+    Array<uint8_t> BuddyAllocator::on_alloc(size_t size, uint32_t align) {
+        auto order = this->_order_for(size, align);
+        if (order > this->max_order) {
+            return { 0, nullptr };
+        }
+
+        auto found = order;
+        while (found <= this->max_order && this->_free_lists[found] == nullptr) {
+            found++;
+        }
+
+        if (found > this->max_order) {
+            return { 0, nullptr };
+        }
+
+        auto offset = static_cast<size_t>(reinterpret_cast<uint8_t*>(this->_free_lists[found]) - this->_base);
+        this->_remove(offset, found);
+
+        // Split down to the requested size, freeing the upper halves
+        while (found > order) {
+            found--;
+            this->_push(offset + (size_t{ 1 } << found), found);
+        }
+
+        return { size_t{ 1 } << order, this->_base + offset };
+    }
+
+    Optional<Array<uint8_t>> BuddyAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (buf.items == nullptr) {
+            auto allocation = this->on_alloc(new_size, buf_align);
+            if (allocation.items == nullptr) {
+                return None;
+            }
+            return allocation;
+        }
+
+        auto offset = static_cast<size_t>(buf.items - this->_base);
+        auto order = this->_order_for(buf.len, buf_align);
+        auto new_order = this->_order_for(new_size, buf_align);
+
+        if (new_order <= order) {
+            // Give back the upper halves; their buddies are still in use so
+            // there is nothing to merge with.
+            while (order > new_order) {
+                order--;
+                this->_push(offset + (size_t{ 1 } << order), order);
+            }
+
+            buf.len = size_t{ 1 } << new_order;
+            return buf;
+        }
+
+        // Growing in place needs the block to be the lower half at every level
+        // up to the new order, with each upper half currently free.
+        bool can_grow = new_order <= this->max_order && offset % (size_t{ 1 } << new_order) == 0;
+        for (auto o = order; can_grow && o < new_order; o++) {
+            can_grow = this->_is_free(offset + (size_t{ 1 } << o), o);
+        }
+
+        if (can_grow) {
+            for (auto o = order; o < new_order; o++) {
+                this->_remove(offset + (size_t{ 1 } << o), o);
+            }
+
+            buf.len = size_t{ 1 } << new_order;
+            return buf;
+        }
+
+        auto allocation = this->on_alloc(new_size, buf_align);
+        if (allocation.items == nullptr) {
+            return None;
+        }
+
+        memcpy(allocation.items, buf.items, buf.len);
+        this->on_free(buf, buf_align);
+
+        return allocation;
+    }
+
+    void BuddyAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+
+        auto offset = static_cast<size_t>(buf.items - this->_base);
+        this->_release(offset, this->_order_for(buf.len, buf_align));
+    }
+}
+
+void sk::Formatter<sk::BuddyStats>::format(const sk::BuddyStats& stats, std::string_view fmt, sk::Writer& writer) {
+    writer.print(
+        "BuddyStats{{ total_bytes: {}, free_bytes: {}, largest_free_block: {}, free_blocks: {}, fragmentation: {:.3} }}",
+        stats.total_bytes, stats.free_bytes, stats.largest_free_block, stats.free_blocks, stats.fragmentation()
+    );
+}
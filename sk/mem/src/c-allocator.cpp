@@ -1,24 +1,77 @@
 #include "../c-allocator.h"
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
 
 namespace sk {
+    size_t internal::malloc_usable_size(void* allocation, size_t requested) noexcept {
+#if defined(__GLIBC__)
+        return ::malloc_usable_size(allocation);
+#elif defined(__APPLE__)
+        return ::malloc_size(allocation);
+#else
+        return requested;
+#endif
+    }
+
+    // malloc and realloc already guarantee this much alignment, anything
+    // stricter has to go through posix_memalign.
+    static bool needs_aligned_allocation(uint32_t align) {
+        return align > alignof(max_align_t);
+    }
+
     Array<uint8_t> CAllocator::on_alloc(size_t size, uint32_t align) {
-        void *allocation = malloc(size);
+        assert(internal::is_power_of_two(align));
+
+        void *allocation = nullptr;
+        if (!needs_aligned_allocation(align)) {
+            allocation = malloc(size);
+        } else if (posix_memalign(&allocation, align, size) != 0) {
+            allocation = nullptr;
+        }
+
+        if (!allocation) {
+            return { 0, nullptr };
+        }
+
+        // malloc rounds up to its own size classes; handing the slack to the
+        // caller lets growable containers use it before reallocating.
         return Array{
-            size,
+            internal::malloc_usable_size(allocation, size),
             reinterpret_cast<uint8_t *>(allocation)
         };
     }
 
     Optional<Array<uint8_t>> CAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (needs_aligned_allocation(buf_align)) {
+            // realloc may move the buffer to an address that only satisfies
+            // the default alignment so we have to move it ourselves.
+            auto new_buf = this->on_alloc(new_size, buf_align);
+            if (!new_buf.items) {
+                return None;
+            }
+
+            if (buf.items) {
+                memcpy(new_buf.items, buf.items, buf.len < new_size ? buf.len : new_size);
+                std::free(buf.items);
+            }
+
+            return new_buf;
+        }
+
         void *new_allocation = realloc(buf.items, new_size);
         if (!new_allocation) {
             return None;
         }
 
         auto new_buf = Array{
-            new_size,
+            internal::malloc_usable_size(new_allocation, new_size),
             reinterpret_cast<uint8_t *>(new_allocation),
         };
 
@@ -28,4 +81,37 @@ namespace sk {
     void CAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
         std::free(buf.items);
     }
+
+    bool CAllocator::on_alloc_batch(size_t size, uint32_t align, Array<uint8_t*> ptrs) {
+        // libc has no batch entry point, but one virtual call and one
+        // alignment check per batch instead of per object is still a win.
+        assert(internal::is_power_of_two(align));
+
+        auto aligned = needs_aligned_allocation(align);
+        for (size_t i = 0; i < ptrs.len; i++) {
+            void *allocation = nullptr;
+            if (!aligned) {
+                allocation = malloc(size);
+            } else if (posix_memalign(&allocation, align, size) != 0) {
+                allocation = nullptr;
+            }
+
+            if (!allocation) {
+                for (size_t j = 0; j < i; j++) {
+                    std::free(ptrs[j]);
+                }
+                return false;
+            }
+
+            ptrs[i] = reinterpret_cast<uint8_t *>(allocation);
+        }
+
+        return true;
+    }
+
+    void CAllocator::on_free_batch(Array<uint8_t*> ptrs, size_t size, uint32_t align) {
+        for (auto ptr : ptrs) {
+            std::free(ptr);
+        }
+    }
 }
@@ -0,0 +1,142 @@
+#include "../concurrent-arena-allocator.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <initializer_list>
+
+namespace sk {
+    ConcurrentArenaAllocator::ConcurrentArenaAllocator(Allocator* allocator, size_t block_size) noexcept :
+        _current(nullptr),
+        _oversized(nullptr),
+        block_size(block_size),
+        ator(allocator)
+    {
+    }
+
+    size_t ConcurrentArenaAllocator::_memory_block_allocation_size(size_t memory_size) {
+        return offsetof(MemoryBlock, memory) + memory_size;
+    }
+
+    size_t ConcurrentArenaAllocator::_reservation_size(size_t size, uint32_t align) noexcept {
+        // Offsets are always multiples of `granularity` so only stricter
+        // alignments need room for padding.
+        auto padding = align > granularity ? align - 1 : 0;
+        return internal::align_forward(size + padding, granularity);
+    }
+
+    ConcurrentArenaAllocator::MemoryBlock* ConcurrentArenaAllocator::_make_block(size_t size, size_t reserved) const noexcept {
+        auto allocation_size = ConcurrentArenaAllocator::_memory_block_allocation_size(size);
+        auto block_allocation = this->ator->alloc<uint8_t>(allocation_size, alignof(MemoryBlock));
+        auto block = reinterpret_cast<MemoryBlock*>(block_allocation.items);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        block->next = nullptr;
+        new (&block->allocated) std::atomic<size_t>(reserved);
+        block->size = size;
+
+        return block;
+    }
+
+    void ConcurrentArenaAllocator::_release_block(MemoryBlock* block) const noexcept {
+        auto allocation_size = ConcurrentArenaAllocator::_memory_block_allocation_size(block->size);
+        this->ator->free(allocation_size, reinterpret_cast<uint8_t*>(block), alignof(MemoryBlock));
+    }
+
+    void ConcurrentArenaAllocator::destroy() noexcept {
+        for (auto head : { &this->_current, &this->_oversized }) {
+            auto it = head->exchange(nullptr, std::memory_order_acquire);
+            while (it) {
+                auto next = it->next;
+                this->_release_block(it);
+                it = next;
+            }
+        }
+    }
+
+    Array<uint8_t> ConcurrentArenaAllocator::on_alloc(size_t size, uint32_t align) {
+        assert(internal::is_power_of_two(align));
+
+        auto reserved = ConcurrentArenaAllocator::_reservation_size(size, align);
+
+        if (reserved > this->block_size) {
+            // Too big to share a block; give it its own and push it on a
+            // separate list so it never becomes the current block.
+            auto block = this->_make_block(reserved, reserved);
+            if (block == nullptr) {
+                return { 0, nullptr };
+            }
+
+            auto head = this->_oversized.load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!this->_oversized.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+
+            auto start = internal::align_forward(reinterpret_cast<uintptr_t>(block->memory), align);
+            return { size, reinterpret_cast<uint8_t*>(start) };
+        }
+
+        auto block = this->_current.load(std::memory_order_acquire);
+        for (;;) {
+            if (block) {
+                auto offset = block->allocated.fetch_add(reserved, std::memory_order_relaxed);
+                if (offset + reserved <= block->size) {
+                    auto start = internal::align_forward(reinterpret_cast<uintptr_t>(&block->memory[offset]), align);
+                    return { size, reinterpret_cast<uint8_t*>(start) };
+                }
+            }
+
+            // The block is exhausted. Build a replacement that already holds
+            // our reservation and try to install it; if another thread beat us
+            // to it, hand ours back and retry against theirs.
+            auto new_block = this->_make_block(this->block_size, reserved);
+            if (new_block == nullptr) {
+                return { 0, nullptr };
+            }
+
+            new_block->next = block;
+            if (this->_current.compare_exchange_strong(block, new_block, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                auto start = internal::align_forward(reinterpret_cast<uintptr_t>(new_block->memory), align);
+                return { size, reinterpret_cast<uint8_t*>(start) };
+            }
+
+            this->_release_block(new_block);
+        }
+    }
+
+    Optional<Array<uint8_t>> ConcurrentArenaAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (new_size <= buf.len) {
+            buf.len = new_size;
+            return buf;
+        }
+
+        // Grow in place if nobody has allocated past this buffer since. The
+        // compare-and-swap fails as soon as another thread has bumped the block.
+        auto block = this->_current.load(std::memory_order_acquire);
+        if (block && buf.items >= block->memory && buf.items < block->memory + block->size) {
+            auto offset = static_cast<size_t>(buf.items - block->memory);
+            auto end = internal::align_forward(offset + buf.len, granularity);
+            auto new_end = internal::align_forward(offset + new_size, granularity);
+            if (new_end <= block->size && block->allocated.compare_exchange_strong(end, new_end, std::memory_order_relaxed)) {
+                buf.len = new_size;
+                return buf;
+            }
+        }
+
+        auto new_allocation = this->on_alloc(new_size, buf_align);
+        if (new_allocation.items == nullptr) {
+            return None;
+        }
+
+        if (buf.len > 0) {
+            memcpy(new_allocation.items, buf.items, buf.len);
+        }
+
+        return new_allocation;
+    }
+
+    void ConcurrentArenaAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        // Everything is released at once by `destroy()`
+    }
+}
@@ -0,0 +1,263 @@
+#include "../huge-page-allocator.h"
+#include "../c-allocator.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace sk {
+    namespace {
+        // Bytes of `[start, end)` backed by transparent huge pages, read from
+        // /proc/self/smaps. Adjacent mappings with identical flags can share a
+        // VMA, in which case the VMA's count is clamped to the overlap.
+        size_t transparent_huge_bytes(uintptr_t start, uintptr_t end) {
+#if defined(__linux__)
+            auto file = fopen("/proc/self/smaps", "r");
+            if (file == nullptr) {
+                return 0;
+            }
+
+            size_t total = 0;
+            size_t overlap = 0;
+            char line[256];
+            while (fgets(line, sizeof(line), file)) {
+                unsigned long lo, hi;
+                size_t kb;
+                if (sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+                    auto overlap_start = lo > start ? lo : start;
+                    auto overlap_end = hi < end ? hi : end;
+                    overlap = overlap_end > overlap_start ? overlap_end - overlap_start : 0;
+                } else if (overlap > 0 && sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+                    auto bytes = kb * 1024;
+                    total += bytes < overlap ? bytes : overlap;
+                }
+            }
+
+            fclose(file);
+            return total;
+#else
+            return 0;
+#endif
+        }
+    }
+
+    HugePageAllocator::HugePageAllocator(Allocator* allocator, size_t threshold, bool try_hugetlb) noexcept :
+        ator(allocator),
+        threshold(threshold),
+        try_hugetlb(try_hugetlb),
+        _lock(),
+        _mappings()
+    {
+    }
+
+    HugePageAllocator::~HugePageAllocator() noexcept {
+        for (auto& mapping : this->_mappings) {
+            munmap(mapping.base, mapping.size);
+        }
+        this->_mappings.destroy(c_allocator);
+    }
+
+    Optional<HugePageAllocator::Mapping> HugePageAllocator::_map(size_t size, uint32_t align) noexcept {
+        auto mapped_size = internal::align_forward(size, huge_page_size);
+
+#if defined(__linux__)
+        // Huge TLB pages are naturally aligned to their size.
+        if (this->try_hugetlb && align <= huge_page_size) {
+            void* base = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (base != MAP_FAILED) {
+                return Mapping{ reinterpret_cast<uint8_t*>(base), mapped_size, HugePageBacking::HugeTLB };
+            }
+        }
+#endif
+
+        // Over-reserve and trim so the mapping starts on a huge page boundary,
+        // otherwise the kernel can only use huge pages for its interior.
+        size_t mapping_align = align > huge_page_size ? align : huge_page_size;
+        auto reserve_size = mapped_size + mapping_align;
+        void* reserved = mmap(nullptr, reserve_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED) {
+            return None;
+        }
+
+        auto reserved_start = reinterpret_cast<uintptr_t>(reserved);
+        auto start = internal::align_forward(reserved_start, mapping_align);
+        if (start > reserved_start) {
+            munmap(reserved, start - reserved_start);
+        }
+        auto tail = reserved_start + reserve_size - (start + mapped_size);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(start + mapped_size), tail);
+        }
+
+        auto base = reinterpret_cast<uint8_t*>(start);
+#if defined(__linux__)
+        auto backing = madvise(base, mapped_size, MADV_HUGEPAGE) == 0 ? HugePageBacking::Transparent : HugePageBacking::Regular;
+#else
+        // Elsewhere the aligned mapping is the best we can do; some kernels
+        // still promote it to superpages on their own.
+        auto backing = HugePageBacking::Regular;
+#endif
+        return Mapping{ base, mapped_size, backing };
+    }
+
+    size_t HugePageAllocator::_find(const uint8_t* ptr) noexcept {
+        for (size_t i = 0; i < this->_mappings.len; i++) {
+            auto& mapping = this->_mappings[i];
+            if (ptr >= mapping.base && ptr < mapping.base + mapping.size) {
+                return i;
+            }
+        }
+        return SIZE_MAX;
+    }
+
+    bool HugePageAllocator::_unmap(const uint8_t* ptr) noexcept {
+        Mapping mapping;
+        {
+            std::lock_guard<std::mutex> guard(this->_lock);
+            auto index = this->_find(ptr);
+            if (index == SIZE_MAX) {
+                return false;
+            }
+
+            mapping = this->_mappings[index];
+            this->_mappings[index] = this->_mappings[this->_mappings.len - 1];
+            this->_mappings.len--;
+        }
+
+        munmap(mapping.base, mapping.size);
+        return true;
+    }
+
+    Optional<HugePageInfo> HugePageAllocator::query(const void* ptr) noexcept {
+        Mapping mapping;
+        {
+            std::lock_guard<std::mutex> guard(this->_lock);
+            auto index = this->_find(reinterpret_cast<const uint8_t*>(ptr));
+            if (index == SIZE_MAX) {
+                return None;
+            }
+            mapping = this->_mappings[index];
+        }
+
+        HugePageInfo info;
+        info.address = mapping.base;
+        info.mapped_size = mapping.size;
+        info.backing = mapping.backing;
+        switch (mapping.backing) {
+            case HugePageBacking::HugeTLB:
+                info.huge_bytes = mapping.size;
+                break;
+            case HugePageBacking::Transparent: {
+                auto start = reinterpret_cast<uintptr_t>(mapping.base);
+                info.huge_bytes = transparent_huge_bytes(start, start + mapping.size);
+            } break;
+            case HugePageBacking::Regular:
+                info.huge_bytes = 0;
+                break;
+        }
+
+        return info;
+    }
+
+    void HugePageAllocator::write_report(Writer& writer) noexcept {
+        List<uint8_t*> bases;
+        {
+            std::lock_guard<std::mutex> guard(this->_lock);
+            for (auto& mapping : this->_mappings) {
+                bases.append(c_allocator, mapping.base);
+            }
+        }
+
+        for (auto base : bases) {
+            auto info = this->query(base);
+            if (info.is_some()) {
+                writer.println("{}", info.unwrap());
+            }
+        }
+
+        bases.destroy(c_allocator);
+    }
+
+    Array<uint8_t> HugePageAllocator::on_alloc(size_t size, uint32_t align) {
+        if (size < this->threshold) {
+            return this->ator->on_alloc(size, align);
+        }
+
+        auto mapping = this->_map(size, align);
+        if (mapping.is_none()) {
+            return { 0, nullptr };
+        }
+
+        auto m = mapping.unwrap();
+        {
+            std::lock_guard<std::mutex> guard(this->_lock);
+            this->_mappings.append(c_allocator, m);
+        }
+
+        // The mapping is whole huge pages, all of it usable.
+        return { m.size, m.base };
+    }
+
+    Optional<Array<uint8_t>> HugePageAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (buf.items == nullptr) {
+            auto allocation = this->on_alloc(new_size, buf_align);
+            if (allocation.items == nullptr) {
+                return None;
+            }
+            return allocation;
+        }
+
+        size_t mapped_size = 0;
+        {
+            std::lock_guard<std::mutex> guard(this->_lock);
+            auto index = this->_find(buf.items);
+            if (index != SIZE_MAX) {
+                mapped_size = this->_mappings[index].size;
+            }
+        }
+
+        // Mappings are whole huge pages, so there is often slack to grow into.
+        if (mapped_size != 0 && new_size <= mapped_size) {
+            buf.len = mapped_size;
+            return buf;
+        }
+
+        if (mapped_size == 0 && new_size < this->threshold) {
+            return this->ator->on_resize(buf, buf_align, new_size);
+        }
+
+        auto allocation = this->on_alloc(new_size, buf_align);
+        if (allocation.items == nullptr) {
+            return None;
+        }
+
+        memcpy(allocation.items, buf.items, buf.len < new_size ? buf.len : new_size);
+        this->on_free(buf, buf_align);
+        return allocation;
+    }
+
+    void HugePageAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+
+        if (!this->_unmap(buf.items)) {
+            this->ator->on_free(buf, buf_align);
+        }
+    }
+}
+
+void sk::Formatter<sk::HugePageBacking>::format(const sk::HugePageBacking& backing, std::string_view fmt, sk::Writer& writer) {
+    switch (backing) {
+        case sk::HugePageBacking::Regular:     writer.write_string("Regular");     break;
+        case sk::HugePageBacking::HugeTLB:     writer.write_string("HugeTLB");     break;
+        case sk::HugePageBacking::Transparent: writer.write_string("Transparent"); break;
+    }
+}
+
+void sk::Formatter<sk::HugePageInfo>::format(const sk::HugePageInfo& info, std::string_view fmt, sk::Writer& writer) {
+    writer.print(
+        "HugePageInfo{{ address: {}, mapped_size: {}, backing: {}, huge_bytes: {} }}",
+        reinterpret_cast<void*>(info.address), info.mapped_size, info.backing, info.huge_bytes
+    );
+}
@@ -0,0 +1,211 @@
+#include "../persistent-arena-allocator.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__linux__) && !defined(MAP_FIXED_NOREPLACE)
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+namespace sk {
+    namespace {
+        constexpr size_t data_alignment = 64;
+
+        // Only Linux can refuse to map over an existing mapping. Elsewhere the
+        // base address is just a hint and the check after mmap does the refusing.
+#if defined(__linux__)
+        constexpr int map_fixed_noreplace = MAP_FIXED_NOREPLACE;
+#else
+        constexpr int map_fixed_noreplace = 0;
+#endif
+
+        size_t data_start() {
+            return internal::align_forward(sizeof(PersistentArenaAllocator::Header), data_alignment);
+        }
+    }
+
+    Optional<PersistentArenaAllocator> PersistentArenaAllocator::open(const char* path, size_t capacity, uintptr_t base) noexcept {
+        auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (base % page_size != 0) {
+            return None;
+        }
+
+        int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return None;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return None;
+        }
+
+        auto created = st.st_size == 0;
+        size_t size;
+        if (created) {
+            size = internal::align_forward(capacity > data_start() ? capacity : data_start(), page_size);
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                ::close(fd);
+                return None;
+            }
+        } else {
+            // Read the header first so the file is validated before anything is mapped at `base`.
+            Header header;
+            if (static_cast<size_t>(st.st_size) < sizeof(Header) || pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+                header.magic != PersistentArenaAllocator::magic || header.version != PersistentArenaAllocator::version ||
+                header.base != base || header.capacity > static_cast<uint64_t>(st.st_size) || header.allocated > header.capacity)
+            {
+                ::close(fd);
+                return None;
+            }
+            size = header.capacity;
+        }
+
+        // Older kernels treat MAP_FIXED_NOREPLACE as a hint, so the address is checked too.
+        void* memory = mmap(reinterpret_cast<void*>(base), size, PROT_READ | PROT_WRITE, MAP_SHARED | map_fixed_noreplace, fd, 0);
+        if (memory == MAP_FAILED) {
+            ::close(fd);
+            return None;
+        }
+        if (reinterpret_cast<uintptr_t>(memory) != base) {
+            munmap(memory, size);
+            ::close(fd);
+            return None;
+        }
+
+        PersistentArenaAllocator arena;
+        arena._header = reinterpret_cast<Header*>(memory);
+        arena._fd = fd;
+        arena.created = created;
+
+        if (created) {
+            arena._header->magic = PersistentArenaAllocator::magic;
+            arena._header->version = PersistentArenaAllocator::version;
+            arena._header->_reserved = 0;
+            arena._header->base = base;
+            arena._header->capacity = size;
+            arena._header->allocated = data_start();
+            arena._header->root = 0;
+        }
+
+        return arena;
+    }
+
+    uint8_t* PersistentArenaAllocator::_base() const noexcept {
+        return reinterpret_cast<uint8_t*>(this->_header);
+    }
+
+    void PersistentArenaAllocator::set_root(const void* root) noexcept {
+        if (root == nullptr) {
+            this->_header->root = 0;
+            return;
+        }
+
+        auto offset = static_cast<size_t>(reinterpret_cast<const uint8_t*>(root) - this->_base());
+        assert(offset >= data_start() && offset < this->_header->allocated);
+        this->_header->root = offset;
+    }
+
+    PersistentArenaAllocator::Mark PersistentArenaAllocator::mark() const noexcept {
+        return { this->_header->allocated };
+    }
+
+    bool PersistentArenaAllocator::rollback(Mark mark) noexcept {
+        if (mark._index < data_start() || mark._index > this->_header->allocated) {
+            return false;
+        }
+
+        this->_header->allocated = mark._index;
+        if (this->_header->root >= mark._index) {
+            this->_header->root = 0;
+        }
+        return true;
+    }
+
+    void PersistentArenaAllocator::reset() noexcept {
+        this->rollback({ data_start() });
+    }
+
+    size_t PersistentArenaAllocator::allocated() const noexcept {
+        return this->_header->allocated - data_start();
+    }
+
+    size_t PersistentArenaAllocator::capacity() const noexcept {
+        return this->_header->capacity - data_start();
+    }
+
+    bool PersistentArenaAllocator::flush() noexcept {
+        if (this->_header == nullptr) {
+            return false;
+        }
+
+        // Only the used prefix can be dirty.
+        auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        auto len = internal::align_forward(this->_header->allocated, page_size);
+        return msync(this->_header, len, MS_SYNC) == 0;
+    }
+
+    void PersistentArenaAllocator::close() noexcept {
+        if (this->_header == nullptr) {
+            return;
+        }
+
+        munmap(this->_header, this->_header->capacity);
+        ::close(this->_fd);
+
+        this->_header = nullptr;
+        this->_fd = -1;
+    }
+
+    Array<uint8_t> PersistentArenaAllocator::on_alloc(size_t size, uint32_t align) {
+        assert(internal::is_power_of_two(align));
+
+        auto base = reinterpret_cast<uintptr_t>(this->_base());
+        auto offset = internal::align_forward(base + this->_header->allocated, align) - base;
+        if (offset + size < offset || offset + size > this->_header->capacity) {
+            return { 0, nullptr };
+        }
+
+        this->_header->allocated = offset + size;
+        return { size, this->_base() + offset };
+    }
+
+    Optional<Array<uint8_t>> PersistentArenaAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        // The most recent allocation grows or shrinks in place, which keeps a
+        // List being built at the end of the arena from leaving copies behind.
+        if (buf.items && buf.items + buf.len == this->_base() + this->_header->allocated) {
+            auto offset = static_cast<size_t>(buf.items - this->_base());
+            if (new_size > this->_header->capacity - offset) {
+                return None;
+            }
+
+            this->_header->allocated = offset + new_size;
+            buf.len = new_size;
+            return buf;
+        }
+
+        if (new_size <= buf.len) {
+            buf.len = new_size;
+            return buf;
+        }
+
+        auto new_allocation = this->on_alloc(new_size, buf_align);
+        if (new_allocation.items == nullptr) {
+            return None;
+        }
+
+        if (buf.len > 0) {
+            memcpy(new_allocation.items, buf.items, buf.len);
+        }
+
+        return new_allocation;
+    }
+
+    void PersistentArenaAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        // Like ArenaAllocator, memory is only given back by `rollback()` or `reset()`
+    }
+}
@@ -0,0 +1,177 @@
+#include "../pool-allocator.h"
+
+#include <initializer_list>
+
+namespace sk {
+    PoolAllocator::PoolAllocator(Allocator* allocator, size_t slot_size, uint32_t slot_align, size_t slab_size) noexcept :
+        _partial(nullptr),
+        _full(nullptr),
+        _empty(nullptr),
+        slot_size(0),
+        slot_align(slot_align > alignof(Slot) ? slot_align : alignof(Slot)),
+        slab_size(slab_size),
+        slots_per_slab(0),
+        ator(allocator)
+    {
+        assert(internal::is_power_of_two(slab_size));
+
+        // Free slots hold the intrusive list link so every slot must fit one.
+        auto min_size = slot_size > sizeof(Slot) ? slot_size : sizeof(Slot);
+        this->slot_size = internal::align_forward(min_size, this->slot_align);
+
+        auto first = this->_first_slot_offset();
+        assert(first + this->slot_size <= slab_size);
+        this->slots_per_slab = (slab_size - first) / this->slot_size;
+    }
+
+    size_t PoolAllocator::_first_slot_offset() const noexcept {
+        return internal::align_forward(sizeof(Slab), this->slot_align);
+    }
+
+    PoolAllocator::Slab* PoolAllocator::_slab_of(const void* ptr) const noexcept {
+        auto addr = reinterpret_cast<uintptr_t>(ptr);
+        return reinterpret_cast<Slab*>(addr & ~static_cast<uintptr_t>(this->slab_size - 1));
+    }
+
+    PoolAllocator::Slab* PoolAllocator::_make_slab() noexcept {
+        if (this->_empty) {
+            auto slab = this->_empty;
+            this->_empty = nullptr;
+            return slab;
+        }
+
+        auto memory = this->ator->alloc<uint8_t>(this->slab_size, static_cast<uint32_t>(this->slab_size));
+        if (memory.items == nullptr) {
+            return nullptr;
+        }
+
+        auto slab = reinterpret_cast<Slab*>(memory.items);
+        slab->prev = nullptr;
+        slab->next = nullptr;
+        slab->free_slots = nullptr;
+        slab->used = 0;
+        slab->carved = 0;
+
+        return slab;
+    }
+
+    void PoolAllocator::_release_slab(Slab* slab) noexcept {
+        this->ator->free(this->slab_size, reinterpret_cast<uint8_t*>(slab), static_cast<uint32_t>(this->slab_size));
+    }
+
+    void PoolAllocator::_link(Slab** list, Slab* slab) noexcept {
+        slab->prev = nullptr;
+        slab->next = *list;
+        if (*list) {
+            (*list)->prev = slab;
+        }
+        *list = slab;
+    }
+
+    void PoolAllocator::_unlink(Slab** list, Slab* slab) noexcept {
+        if (slab->prev) {
+            slab->prev->next = slab->next;
+        } else {
+            *list = slab->next;
+        }
+
+        if (slab->next) {
+            slab->next->prev = slab->prev;
+        }
+
+        slab->prev = nullptr;
+        slab->next = nullptr;
+    }
+
+    void PoolAllocator::destroy() noexcept {
+        for (auto list : { &this->_partial, &this->_full }) {
+            auto it = *list;
+            while (it) {
+                auto next = it->next;
+                this->_release_slab(it);
+                it = next;
+            }
+            *list = nullptr;
+        }
+
+        if (this->_empty) {
+            this->_release_slab(this->_empty);
+            this->_empty = nullptr;
+        }
+    }
+
+    Array<uint8_t> PoolAllocator::on_alloc(size_t size, uint32_t align) {
+        assert(size <= this->slot_size && align <= this->slot_align);
+
+        auto slab = this->_partial;
+        if (slab == nullptr) {
+            slab = this->_make_slab();
+            if (slab == nullptr) {
+                return { 0, nullptr };
+            }
+            PoolAllocator::_link(&this->_partial, slab);
+        }
+
+        uint8_t* slot;
+        if (slab->free_slots) {
+            slot = reinterpret_cast<uint8_t*>(slab->free_slots);
+            slab->free_slots = slab->free_slots->next;
+        } else {
+            // Slots are carved lazily so a fresh slab is never walked up front.
+            slot = reinterpret_cast<uint8_t*>(slab) + this->_first_slot_offset() + slab->carved * this->slot_size;
+            slab->carved++;
+        }
+
+        slab->used++;
+        if (slab->used == this->slots_per_slab) {
+            PoolAllocator::_unlink(&this->_partial, slab);
+            PoolAllocator::_link(&this->_full, slab);
+        }
+
+        return { size, slot };
+    }
+
+    Optional<Array<uint8_t>> PoolAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (buf.items == nullptr) {
+            return this->on_alloc(new_size, buf_align);
+        }
+
+        if (new_size > this->slot_size) {
+            return None;
+        }
+
+        buf.len = new_size;
+        return buf;
+    }
+
+    void PoolAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+
+        auto slab = this->_slab_of(buf.items);
+        if (slab->used == this->slots_per_slab) {
+            PoolAllocator::_unlink(&this->_full, slab);
+            PoolAllocator::_link(&this->_partial, slab);
+        }
+
+        auto slot = reinterpret_cast<Slot*>(buf.items);
+        slot->next = slab->free_slots;
+        slab->free_slots = slot;
+        slab->used--;
+
+        if (slab->used == 0) {
+            PoolAllocator::_unlink(&this->_partial, slab);
+
+            // Keep one empty slab around so alternating alloc/free right at a
+            // slab boundary does not bounce to the upstream allocator.
+            slab->free_slots = nullptr;
+            slab->carved = 0;
+            if (this->_empty == nullptr) {
+                this->_empty = slab;
+            } else {
+                this->_release_slab(slab);
+            }
+        }
+    }
+}
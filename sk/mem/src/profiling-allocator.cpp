@@ -0,0 +1,170 @@
+#include "../profiling-allocator.h"
+#include "../c-allocator.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <execinfo.h>
+
+namespace sk {
+    namespace {
+        // Frames belonging to the profiler itself: _record_sample, _account
+        // and on_alloc/on_resize. The first two are kept out of line so the
+        // count holds in optimized builds.
+        constexpr int skipped_frames = 3;
+
+        thread_local int64_t bytes_until_sample = -1;
+        thread_local uint64_t sample_rng = 0;
+
+        // Exponentially distributed gaps make the samples a Poisson process, so
+        // allocations that happen to line up with a fixed interval are not over
+        // or under counted.
+        int64_t next_sample_gap(size_t interval) {
+            if (sample_rng == 0) {
+                sample_rng = reinterpret_cast<uintptr_t>(&sample_rng) | 1;
+            }
+
+            sample_rng ^= sample_rng << 13;
+            sample_rng ^= sample_rng >> 7;
+            sample_rng ^= sample_rng << 17;
+
+            auto u = (static_cast<double>(sample_rng >> 11) + 1.0) / 9007199254740993.0;
+            return static_cast<int64_t>(-log(u) * static_cast<double>(interval)) + 1;
+        }
+
+        uint64_t hash_frames(void* const* frames, size_t count) {
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < count; i++) {
+                hash ^= reinterpret_cast<uintptr_t>(frames[i]);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        void write_frame(Writer& writer, void* frame) {
+            Dl_info info;
+            if (dladdr(frame, &info) && info.dli_sname) {
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                const char* name = status == 0 && demangled ? demangled : info.dli_sname;
+
+                // ';' separates frames in the folded format
+                for (const char* c = name; *c; c++) {
+                    writer.write_char(*c == ';' ? ':' : *c);
+                }
+
+                ::free(demangled);
+                return;
+            }
+
+            writer.write_ptr(frame);
+        }
+    }
+
+    ProfilingAllocator::ProfilingAllocator(Allocator* allocator, size_t sample_interval) noexcept :
+        ator(allocator),
+        sample_interval(sample_interval > 0 ? sample_interval : 1),
+        _lock(),
+        _stacks()
+    {
+    }
+
+    ProfilingAllocator::~ProfilingAllocator() noexcept {
+        this->_stacks.destroy(c_allocator);
+    }
+
+    __attribute__((noinline)) void ProfilingAllocator::_account(size_t size) noexcept {
+        if (bytes_until_sample < 0) {
+            bytes_until_sample = next_sample_gap(this->sample_interval);
+        }
+
+        bytes_until_sample -= static_cast<int64_t>(size);
+        if (bytes_until_sample > 0) {
+            return;
+        }
+
+        bytes_until_sample = next_sample_gap(this->sample_interval);
+
+        // A sample stands for `sample_interval` bytes unless the allocation
+        // itself was bigger, which keeps the totals unbiased.
+        this->_record_sample(size > this->sample_interval ? size : this->sample_interval);
+    }
+
+    __attribute__((noinline)) void ProfilingAllocator::_record_sample(size_t bytes) noexcept {
+        void* frames[max_frames + skipped_frames];
+        int captured = backtrace(frames, max_frames + skipped_frames);
+
+        auto first = captured > skipped_frames ? skipped_frames : 0;
+        auto count = static_cast<size_t>(captured - first);
+        auto hash = hash_frames(&frames[first], count);
+
+        std::lock_guard<std::mutex> guard{ this->_lock };
+
+        for (auto& record : this->_stacks) {
+            if (record.hash == hash && record.frame_count == count && memcmp(record.frames, &frames[first], count * sizeof(void*)) == 0) {
+                record.samples++;
+                record.bytes += bytes;
+                return;
+            }
+        }
+
+        // Records are kept with the C allocator so profiling never feeds back into itself
+        StackRecord record;
+        record.hash = hash;
+        record.frame_count = count;
+        memcpy(record.frames, &frames[first], count * sizeof(void*));
+        record.samples = 1;
+        record.bytes = bytes;
+        this->_stacks.append(c_allocator, record);
+    }
+
+    size_t ProfilingAllocator::sampled_bytes() noexcept {
+        std::lock_guard<std::mutex> guard{ this->_lock };
+
+        size_t total = 0;
+        for (auto& record : this->_stacks) {
+            total += record.bytes;
+        }
+        return total;
+    }
+
+    void ProfilingAllocator::write_folded(Writer& writer) noexcept {
+        std::lock_guard<std::mutex> guard{ this->_lock };
+
+        for (auto& record : this->_stacks) {
+            // backtrace() lists the innermost frame first, folded stacks start at the root
+            for (size_t i = record.frame_count; i > 0; i--) {
+                write_frame(writer, record.frames[i - 1]);
+                if (i > 1) {
+                    writer.write_char(';');
+                }
+            }
+
+            writer.print(" {}\n", record.bytes);
+        }
+    }
+
+    void ProfilingAllocator::clear() noexcept {
+        std::lock_guard<std::mutex> guard{ this->_lock };
+        this->_stacks.len = 0;
+    }
+
+    Array<uint8_t> ProfilingAllocator::on_alloc(size_t size, uint32_t align) {
+        this->_account(size);
+        return this->ator->on_alloc(size, align);
+    }
+
+    Optional<Array<uint8_t>> ProfilingAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (new_size > buf.len) {
+            this->_account(new_size - buf.len);
+        }
+
+        return this->ator->on_resize(buf, buf_align, new_size);
+    }
+
+    void ProfilingAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        this->ator->on_free(buf, buf_align);
+    }
+}
@@ -0,0 +1,53 @@
+#include "../scratch.h"
+#include "../c-allocator.h"
+
+namespace sk {
+    namespace {
+        // Two arenas are enough to keep a result and the temporaries used to
+        // build it apart, however deep the calls nest.
+        constexpr size_t scratch_arena_count = 2;
+
+        struct ScratchArenas {
+            ArenaAllocator arenas[scratch_arena_count];
+
+            ScratchArenas() noexcept {
+                auto policy = ArenaGrowthPolicy{};
+                policy.growth_factor = 2;
+                policy.max_block_size = 1024 * 1024;
+                policy.max_retained = 8 * 1024 * 1024;
+
+                for (auto& arena : this->arenas) {
+                    arena = ArenaAllocator{ &c_allocator, 64 * 1024, policy };
+                }
+            }
+
+            ~ScratchArenas() noexcept {
+                for (auto& arena : this->arenas) {
+                    arena.destroy();
+                }
+            }
+        };
+
+        thread_local ScratchArenas scratch_arenas;
+    }
+
+    Scratch::Scratch(ArenaAllocator& arena) noexcept :
+        arena(arena),
+        _mark(arena.mark())
+    {
+    }
+
+    Scratch::~Scratch() noexcept {
+        this->arena.rollback(this->_mark);
+    }
+
+    Scratch scratch(const Allocator* conflict) noexcept {
+        for (auto& arena : scratch_arenas.arenas) {
+            if (&arena != conflict) {
+                return Scratch{ arena };
+            }
+        }
+
+        return Scratch{ scratch_arenas.arenas[0] };
+    }
+}
@@ -0,0 +1,279 @@
+#include "../size-class-allocator.h"
+#include "../c-allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+
+namespace sk {
+    namespace {
+        struct FreeObject {
+            FreeObject* next;
+        };
+
+        struct alignas(64) CentralBin {
+            std::mutex lock;
+            FreeObject* head;
+            size_t count;
+            size_t allocs;
+            size_t frees;
+            size_t refills;
+            size_t flushes;
+            size_t spans;
+        };
+
+        CentralBin central[SizeClassAllocator::class_count];
+
+        constexpr size_t span_size = 64 * 1024;
+
+        size_t floor_log2(size_t n) {
+            return 63 - __builtin_clzll(n);
+        }
+
+        // Objects moved between a thread cache and the central heap at once.
+        // Small classes move many objects per lock, large ones only a few.
+        uint32_t batch_size(size_t index) {
+            auto count = 32 * 1024 / SizeClassAllocator::class_size(index);
+            if (count < 4) return 4;
+            if (count > 128) return 128;
+            return static_cast<uint32_t>(count);
+        }
+
+        // Pops up to `n` objects off the central bin, carving a new span when
+        // it runs dry. Returns the number of objects chained from `out_head`.
+        uint32_t central_take(size_t index, uint32_t n, FreeObject** out_head) {
+            auto& bin = central[index];
+            std::lock_guard<std::mutex> guard{ bin.lock };
+
+            if (bin.head == nullptr) {
+                auto size = SizeClassAllocator::class_size(index);
+                auto len = span_size > size * n ? span_size : size * n;
+                auto span = reinterpret_cast<uint8_t*>(malloc(len));
+                if (span == nullptr) {
+                    *out_head = nullptr;
+                    return 0;
+                }
+
+                FreeObject* head = nullptr;
+                auto objects = len / size;
+                for (size_t i = objects; i > 0; i--) {
+                    auto object = reinterpret_cast<FreeObject*>(span + (i - 1) * size);
+                    object->next = head;
+                    head = object;
+                }
+
+                bin.head = head;
+                bin.count += objects;
+                bin.spans++;
+            }
+
+            auto head = bin.head;
+            auto tail = head;
+            uint32_t taken = 1;
+            while (taken < n && tail->next) {
+                tail = tail->next;
+                taken++;
+            }
+
+            bin.head = tail->next;
+            bin.count -= taken;
+            bin.refills++;
+            tail->next = nullptr;
+
+            *out_head = head;
+            return taken;
+        }
+
+        void central_give(size_t index, FreeObject* head, FreeObject* tail, uint32_t n, size_t allocs, size_t frees) {
+            auto& bin = central[index];
+            std::lock_guard<std::mutex> guard{ bin.lock };
+
+            if (head) {
+                tail->next = bin.head;
+                bin.head = head;
+                bin.count += n;
+                bin.flushes++;
+            }
+
+            bin.allocs += allocs;
+            bin.frees += frees;
+        }
+
+        struct ThreadCache {
+            struct Bin {
+                FreeObject* head;
+                uint32_t count;
+                size_t allocs;
+                size_t frees;
+            };
+
+            Bin bins[SizeClassAllocator::class_count];
+
+            // Returns `n` objects from the front of the bin to the central heap.
+            void flush(size_t index, uint32_t n) {
+                auto& bin = this->bins[index];
+
+                FreeObject* head = nullptr;
+                FreeObject* tail = nullptr;
+                if (n > 0) {
+                    head = bin.head;
+                    tail = head;
+                    for (uint32_t i = 1; i < n; i++) {
+                        tail = tail->next;
+                    }
+                    bin.head = tail->next;
+                    bin.count -= n;
+                }
+
+                central_give(index, head, tail, n, bin.allocs, bin.frees);
+                bin.allocs = 0;
+                bin.frees = 0;
+            }
+
+            void flush_all() {
+                for (size_t i = 0; i < SizeClassAllocator::class_count; i++) {
+                    this->flush(i, this->bins[i].count);
+                }
+            }
+
+            ~ThreadCache() {
+                this->flush_all();
+            }
+        };
+
+        thread_local ThreadCache thread_cache;
+    }
+
+    bool SizeClassAllocator::is_small(size_t size, uint32_t align) noexcept {
+        return size <= max_small_size && align <= min_align;
+    }
+
+    size_t SizeClassAllocator::class_of(size_t size) noexcept {
+        assert(size <= max_small_size);
+        if (size <= 128) {
+            // 16 byte steps up to 128
+            return size == 0 ? 0 : (size + 15) / 16 - 1;
+        }
+
+        // Four classes per power of two after that
+        auto lg = floor_log2(size - 1);
+        auto quarter = ((size - 1) >> (lg - 2)) & 3;
+        return 8 + (lg - 7) * 4 + quarter;
+    }
+
+    size_t SizeClassAllocator::class_size(size_t index) noexcept {
+        assert(index < class_count);
+        if (index < 8) {
+            return (index + 1) * 16;
+        }
+
+        auto lg = (index - 8) / 4 + 7;
+        auto quarter = (index - 8) % 4;
+        return (5 + quarter) << (lg - 2);
+    }
+
+    SizeClassStats SizeClassAllocator::stats(size_t index) noexcept {
+        auto& bin = central[index];
+        std::lock_guard<std::mutex> guard{ bin.lock };
+
+        return SizeClassStats{
+            class_size(index),
+            bin.allocs,
+            bin.frees,
+            bin.refills,
+            bin.flushes,
+            bin.spans,
+            bin.count,
+        };
+    }
+
+    void SizeClassAllocator::flush_thread_cache() noexcept {
+        thread_cache.flush_all();
+    }
+
+    Array<uint8_t> SizeClassAllocator::on_alloc(size_t size, uint32_t align) {
+        if (!is_small(size, align)) {
+            return c_allocator.on_alloc(size, align);
+        }
+
+        auto index = class_of(size);
+        auto& bin = thread_cache.bins[index];
+        if (bin.head == nullptr) {
+            bin.count = central_take(index, batch_size(index), &bin.head);
+            if (bin.head == nullptr) {
+                return { 0, nullptr };
+            }
+        }
+
+        auto object = bin.head;
+        bin.head = object->next;
+        bin.count--;
+        bin.allocs++;
+
+        return { class_size(index), reinterpret_cast<uint8_t*>(object) };
+    }
+
+    Optional<Array<uint8_t>> SizeClassAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        auto was_small = is_small(buf.len, buf_align);
+        auto now_small = is_small(new_size, buf_align);
+
+        if (buf.items == nullptr) {
+            auto allocation = this->on_alloc(new_size, buf_align);
+            if (allocation.items == nullptr) {
+                return None;
+            }
+            return allocation;
+        }
+
+        if (was_small && now_small && class_of(buf.len) == class_of(new_size)) {
+            buf.len = class_size(class_of(new_size));
+            return buf;
+        }
+
+        if (!was_small && !now_small) {
+            return c_allocator.on_resize(buf, buf_align, new_size);
+        }
+
+        auto allocation = this->on_alloc(new_size, buf_align);
+        if (allocation.items == nullptr) {
+            return None;
+        }
+
+        memcpy(allocation.items, buf.items, buf.len < new_size ? buf.len : new_size);
+        this->on_free(buf, buf_align);
+
+        return allocation;
+    }
+
+    void SizeClassAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+
+        if (!is_small(buf.len, buf_align)) {
+            c_allocator.on_free(buf, buf_align);
+            return;
+        }
+
+        auto index = class_of(buf.len);
+        auto& bin = thread_cache.bins[index];
+
+        auto object = reinterpret_cast<FreeObject*>(buf.items);
+        object->next = bin.head;
+        bin.head = object;
+        bin.count++;
+        bin.frees++;
+
+        auto batch = batch_size(index);
+        if (bin.count >= 2 * batch) {
+            thread_cache.flush(index, batch);
+        }
+    }
+}
+
+void sk::Formatter<sk::SizeClassStats>::format(const sk::SizeClassStats& stats, std::string_view fmt, sk::Writer& writer) {
+    writer.print(
+        "SizeClassStats{{ size: {}, allocs: {}, frees: {}, refills: {}, flushes: {}, spans: {}, central: {} }}",
+        stats.size, stats.allocs, stats.frees, stats.refills, stats.flushes, stats.spans, stats.central
+    );
+}
@@ -0,0 +1,444 @@
+#include "../tlsf-allocator.h"
+
+#include <string.h>
+
+namespace sk {
+    namespace {
+        using Block = TLSFAllocator::Block;
+
+        constexpr size_t block_free_bit = 1;
+        constexpr size_t block_prev_free_bit = 2;
+
+        // User memory starts right after `size`; `prev_phys` belongs to the
+        // previous block, so only `size` is real per-block overhead.
+        constexpr size_t block_header_overhead = sizeof(size_t);
+        constexpr size_t block_start_offset = offsetof(Block, size) + sizeof(size_t);
+        constexpr size_t block_size_min = sizeof(Block) - sizeof(Block*);
+        constexpr size_t block_size_max = size_t{ 1 } << TLSFAllocator::fl_index_max;
+
+        // The pool is bracketed by the first block's size word and a zero sized sentinel.
+        constexpr size_t pool_overhead = 2 * block_header_overhead;
+
+        size_t fls(size_t n) {
+            return 63 - __builtin_clzll(n);
+        }
+
+        size_t ffs(uint32_t n) {
+            return __builtin_ctz(n);
+        }
+
+        size_t block_size(const Block* block) {
+            return block->size & ~(block_free_bit | block_prev_free_bit);
+        }
+
+        void block_set_size(Block* block, size_t size) {
+            block->size = size | (block->size & (block_free_bit | block_prev_free_bit));
+        }
+
+        bool block_is_free(const Block* block) {
+            return block->size & block_free_bit;
+        }
+
+        bool block_is_prev_free(const Block* block) {
+            return block->size & block_prev_free_bit;
+        }
+
+        void block_set_prev_free(Block* block, bool free) {
+            block->size = free ? block->size | block_prev_free_bit : block->size & ~block_prev_free_bit;
+        }
+
+        Block* block_from_ptr(const uint8_t* ptr) {
+            return reinterpret_cast<Block*>(const_cast<uint8_t*>(ptr) - block_start_offset);
+        }
+
+        uint8_t* block_to_ptr(const Block* block) {
+            return reinterpret_cast<uint8_t*>(const_cast<Block*>(block)) + block_start_offset;
+        }
+
+        Block* offset_to_block(const uint8_t* ptr, ptrdiff_t offset) {
+            return reinterpret_cast<Block*>(const_cast<uint8_t*>(ptr) + offset);
+        }
+
+        Block* block_next(const Block* block) {
+            return offset_to_block(block_to_ptr(block), block_size(block) - block_header_overhead);
+        }
+
+        Block* block_link_next(Block* block) {
+            auto next = block_next(block);
+            next->prev_phys = block;
+            return next;
+        }
+
+        void block_mark_as_free(Block* block) {
+            auto next = block_link_next(block);
+            block_set_prev_free(next, true);
+            block->size |= block_free_bit;
+        }
+
+        void block_mark_as_used(Block* block) {
+            auto next = block_next(block);
+            block_set_prev_free(next, false);
+            block->size &= ~block_free_bit;
+        }
+
+        bool block_can_split(const Block* block, size_t size) {
+            return block_size(block) >= sizeof(Block) + size;
+        }
+
+        // Carves `size` bytes off the front of `block` and returns the
+        // (free, unlinked) remainder.
+        Block* block_split(Block* block, size_t size) {
+            auto remaining = offset_to_block(block_to_ptr(block), size - block_header_overhead);
+            auto remaining_size = block_size(block) - (size + block_header_overhead);
+
+            remaining->size = 0;
+            block_set_size(remaining, remaining_size);
+            block_set_size(block, size);
+            block_mark_as_free(remaining);
+
+            return remaining;
+        }
+
+        Block* block_absorb(Block* prev, Block* block) {
+            prev->size += block_size(block) + block_header_overhead;
+            block_link_next(prev);
+            return prev;
+        }
+
+        void mapping_insert(size_t size, size_t* fl, size_t* sl) {
+            if (size < TLSFAllocator::small_block_size) {
+                *fl = 0;
+                *sl = size / (TLSFAllocator::small_block_size / TLSFAllocator::sl_index_count);
+            } else {
+                auto f = fls(size);
+                *sl = (size >> (f - TLSFAllocator::sl_index_count_log2)) ^ TLSFAllocator::sl_index_count;
+                *fl = f - (TLSFAllocator::fl_index_shift - 1);
+            }
+        }
+
+        // Rounds up to the next list boundary so any block found there is
+        // large enough, which is what keeps the search to two bit scans.
+        void mapping_search(size_t size, size_t* fl, size_t* sl) {
+            if (size >= TLSFAllocator::small_block_size) {
+                size += (size_t{ 1 } << (fls(size) - TLSFAllocator::sl_index_count_log2)) - 1;
+            }
+            mapping_insert(size, fl, sl);
+        }
+
+        size_t adjust_request_size(size_t size, size_t align) {
+            if (size == 0) {
+                return 0;
+            }
+
+            auto aligned = internal::align_forward(size, align);
+            if (aligned >= block_size_max) {
+                return 0;
+            }
+
+            return aligned < block_size_min ? block_size_min : aligned;
+        }
+    }
+
+    Optional<TLSFAllocator> TLSFAllocator::make(Allocator* allocator, size_t pool_size) noexcept {
+        auto memory = allocator->alloc<uint8_t>(pool_size, alignof(max_align_t));
+        if (memory.items == nullptr) {
+            return None;
+        }
+
+        auto tlsf = TLSFAllocator::make(memory);
+        if (tlsf.is_none()) {
+            allocator->free(memory, alignof(max_align_t));
+            return None;
+        }
+
+        auto result = tlsf.unwrap();
+        result._owns_pool = true;
+        result.ator = allocator;
+        return result;
+    }
+
+    Optional<TLSFAllocator> TLSFAllocator::make(Array<uint8_t> memory) noexcept {
+        auto start = internal::align_forward(reinterpret_cast<uintptr_t>(memory.items), align_size);
+        auto end = reinterpret_cast<uintptr_t>(memory.items) + memory.len;
+        if (memory.items == nullptr || end < start + pool_overhead + block_size_min) {
+            return None;
+        }
+
+        auto pool_bytes = (end - start - pool_overhead) & ~(align_size - 1);
+        if (pool_bytes < block_size_min || pool_bytes >= block_size_max) {
+            return None;
+        }
+
+        TLSFAllocator tlsf;
+        tlsf._pool = memory;
+        tlsf._owns_pool = false;
+        tlsf.ator = nullptr;
+        tlsf._init({ pool_bytes, reinterpret_cast<uint8_t*>(start) });
+
+        return tlsf;
+    }
+
+    void TLSFAllocator::_init(Array<uint8_t> memory) noexcept {
+        this->_fl_bitmap = 0;
+        memset(this->_sl_bitmap, 0, sizeof(this->_sl_bitmap));
+        memset(this->_blocks, 0, sizeof(this->_blocks));
+
+        // The first block's `prev_phys` would sit before the pool, which is
+        // fine since it is never read while the previous block is "used".
+        auto block = offset_to_block(memory.items, -static_cast<ptrdiff_t>(block_header_overhead));
+        block->size = memory.len | block_free_bit;
+        this->_insert_free_block(block);
+
+        auto sentinel = block_link_next(block);
+        sentinel->size = block_prev_free_bit;
+    }
+
+    void TLSFAllocator::_insert_free_block(Block* block) noexcept {
+        size_t fl, sl;
+        mapping_insert(block_size(block), &fl, &sl);
+
+        auto head = this->_blocks[fl][sl];
+        block->next_free = head;
+        block->prev_free = nullptr;
+        if (head) {
+            head->prev_free = block;
+        }
+
+        this->_blocks[fl][sl] = block;
+        this->_fl_bitmap |= uint32_t{ 1 } << fl;
+        this->_sl_bitmap[fl] |= uint32_t{ 1 } << sl;
+    }
+
+    void TLSFAllocator::_remove_free_block(Block* block) noexcept {
+        size_t fl, sl;
+        mapping_insert(block_size(block), &fl, &sl);
+
+        auto prev = block->prev_free;
+        auto next = block->next_free;
+        if (next) {
+            next->prev_free = prev;
+        }
+        if (prev) {
+            prev->next_free = next;
+            return;
+        }
+
+        this->_blocks[fl][sl] = next;
+        if (next == nullptr) {
+            this->_sl_bitmap[fl] &= ~(uint32_t{ 1 } << sl);
+            if (this->_sl_bitmap[fl] == 0) {
+                this->_fl_bitmap &= ~(uint32_t{ 1 } << fl);
+            }
+        }
+    }
+
+    Block* TLSFAllocator::_locate_free(size_t size) noexcept {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        size_t fl, sl;
+        mapping_search(size, &fl, &sl);
+        if (fl >= fl_index_count) {
+            return nullptr;
+        }
+
+        auto sl_map = this->_sl_bitmap[fl] & (~uint32_t{ 0 } << sl);
+        if (sl_map == 0) {
+            auto fl_map = fl + 1 < 32 ? this->_fl_bitmap & (~uint32_t{ 0 } << (fl + 1)) : 0;
+            if (fl_map == 0) {
+                return nullptr;
+            }
+
+            fl = ffs(fl_map);
+            sl_map = this->_sl_bitmap[fl];
+        }
+
+        sl = ffs(sl_map);
+        auto block = this->_blocks[fl][sl];
+        this->_remove_free_block(block);
+        return block;
+    }
+
+    Block* TLSFAllocator::_merge_prev(Block* block) noexcept {
+        if (block_is_prev_free(block)) {
+            auto prev = block->prev_phys;
+            this->_remove_free_block(prev);
+            block = block_absorb(prev, block);
+        }
+        return block;
+    }
+
+    Block* TLSFAllocator::_merge_next(Block* block) noexcept {
+        auto next = block_next(block);
+        if (block_is_free(next)) {
+            this->_remove_free_block(next);
+            block = block_absorb(block, next);
+        }
+        return block;
+    }
+
+    void TLSFAllocator::_trim_free(Block* block, size_t size) noexcept {
+        if (block_can_split(block, size)) {
+            auto remaining = block_split(block, size);
+            block_link_next(block);
+            block_set_prev_free(remaining, true);
+            this->_insert_free_block(remaining);
+        }
+    }
+
+    void TLSFAllocator::_trim_used(Block* block, size_t size) noexcept {
+        if (block_can_split(block, size)) {
+            auto remaining = block_split(block, size);
+            block_set_prev_free(remaining, false);
+            remaining = this->_merge_next(remaining);
+            this->_insert_free_block(remaining);
+        }
+    }
+
+    Block* TLSFAllocator::_trim_free_leading(Block* block, size_t size) noexcept {
+        auto remaining = block;
+        if (block_can_split(block, size)) {
+            remaining = block_split(block, size - block_header_overhead);
+            block_set_prev_free(remaining, true);
+            block_link_next(block);
+            this->_insert_free_block(block);
+        }
+        return remaining;
+    }
+
+    uint8_t* TLSFAllocator::_alloc(size_t size, uint32_t align) noexcept {
+        assert(internal::is_power_of_two(align));
+
+        auto adjusted = adjust_request_size(size, align_size);
+        if (adjusted == 0) {
+            return nullptr;
+        }
+
+        // Over-aligned requests over-allocate so a leading gap big enough to
+        // hold a free block can be split off in front of the aligned address.
+        constexpr size_t gap_minimum = sizeof(Block);
+        auto search_size = adjusted;
+        if (align > align_size) {
+            search_size = adjust_request_size(adjusted + align + gap_minimum, align);
+            if (search_size == 0) {
+                return nullptr;
+            }
+        }
+
+        auto block = this->_locate_free(search_size);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        if (align > align_size) {
+            auto ptr = reinterpret_cast<uintptr_t>(block_to_ptr(block));
+            auto aligned = internal::align_forward(ptr, align);
+            auto gap = aligned - ptr;
+            if (gap != 0 && gap < gap_minimum) {
+                auto gap_remain = gap_minimum - gap;
+                auto offset = gap_remain > align ? gap_remain : align;
+                aligned = internal::align_forward(aligned + offset, align);
+                gap = aligned - ptr;
+            }
+
+            if (gap != 0) {
+                block = this->_trim_free_leading(block, gap);
+            }
+        }
+
+        this->_trim_free(block, adjusted);
+        block_mark_as_used(block);
+        return block_to_ptr(block);
+    }
+
+    void TLSFAllocator::_free(uint8_t* ptr) noexcept {
+        auto block = block_from_ptr(ptr);
+        assert(!block_is_free(block));
+
+        block_mark_as_free(block);
+        block = this->_merge_prev(block);
+        block = this->_merge_next(block);
+        this->_insert_free_block(block);
+    }
+
+    size_t TLSFAllocator::free_bytes() const noexcept {
+        size_t total = 0;
+        for (size_t fl = 0; fl < fl_index_count; fl++) {
+            for (size_t sl = 0; sl < sl_index_count; sl++) {
+                for (auto it = this->_blocks[fl][sl]; it != nullptr; it = it->next_free) {
+                    total += block_size(it);
+                }
+            }
+        }
+        return total;
+    }
+
+    void TLSFAllocator::destroy() noexcept {
+        if (this->_owns_pool && this->_pool.items != nullptr) {
+            this->ator->free(this->_pool, alignof(max_align_t));
+        }
+
+        this->_pool = { 0, nullptr };
+        this->_owns_pool = false;
+        this->_fl_bitmap = 0;
+        memset(this->_sl_bitmap, 0, sizeof(this->_sl_bitmap));
+        memset(this->_blocks, 0, sizeof(this->_blocks));
+    }
+
+    Array<uint8_t> TLSFAllocator::on_alloc(size_t size, uint32_t align) {
+        auto ptr = this->_alloc(size, align);
+        if (ptr == nullptr) {
+            return { 0, nullptr };
+        }
+        return { block_size(block_from_ptr(ptr)), ptr };
+    }
+
+    Optional<Array<uint8_t>> TLSFAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        if (buf.items == nullptr) {
+            auto allocation = this->on_alloc(new_size, buf_align);
+            if (allocation.items == nullptr) {
+                return None;
+            }
+            return allocation;
+        }
+
+        auto block = block_from_ptr(buf.items);
+        auto next = block_next(block);
+        auto current_size = block_size(block);
+        auto combined_size = current_size + block_size(next) + block_header_overhead;
+        auto adjusted = adjust_request_size(new_size, align_size);
+        if (adjusted == 0 && new_size != 0) {
+            return None;
+        }
+
+        // Grow in place by absorbing a free physical successor, otherwise move.
+        if (adjusted > current_size && (!block_is_free(next) || adjusted > combined_size)) {
+            auto ptr = this->_alloc(new_size, buf_align);
+            if (ptr == nullptr) {
+                return None;
+            }
+
+            memcpy(ptr, buf.items, buf.len < new_size ? buf.len : new_size);
+            this->_free(buf.items);
+            return Array<uint8_t>{ block_size(block_from_ptr(ptr)), ptr };
+        }
+
+        if (adjusted > current_size) {
+            this->_merge_next(block);
+            block_mark_as_used(block);
+        }
+
+        // Shrinking, or the tail left over after absorbing, goes back to the lists.
+        this->_trim_used(block, adjusted < block_size_min ? block_size_min : adjusted);
+        buf.len = block_size(block);
+        return buf;
+    }
+
+    void TLSFAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+        this->_free(buf.items);
+    }
+}
@@ -0,0 +1,194 @@
+#include "../tracking-allocator.h"
+
+#include <chrono>
+
+namespace sk {
+    namespace {
+        std::atomic<size_t> next_shard{ 0 };
+        thread_local size_t thread_shard = next_shard.fetch_add(1, std::memory_order_relaxed) % TrackingAllocator::shard_count;
+
+        uint64_t now_ns() {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        }
+
+        size_t histogram_bucket(size_t size) {
+            if (size == 0) {
+                return 0;
+            }
+
+            auto bucket = static_cast<size_t>(64 - __builtin_clzll(size));
+            return bucket < AllocationStats::histogram_buckets ? bucket : AllocationStats::histogram_buckets - 1;
+        }
+
+        void add(std::atomic<uint64_t>& counter, uint64_t n) {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        void store_max(std::atomic<uint64_t>& counter, uint64_t n) {
+            auto current = counter.load(std::memory_order_relaxed);
+            while (n > current && !counter.compare_exchange_weak(current, n, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    TrackingAllocator::TrackingAllocator(Allocator* allocator, bool measure_latency, bool track_peak) noexcept :
+        ator(allocator),
+        measure_latency(measure_latency),
+        track_peak(track_peak),
+        _live(0),
+        _peak(0),
+        _shards()
+    {
+    }
+
+    TrackingAllocator::Shard& TrackingAllocator::_shard() noexcept {
+        return this->_shards[thread_shard];
+    }
+
+    void TrackingAllocator::_add_live(Shard& shard, size_t bytes) noexcept {
+        add(shard.live_bytes, bytes);
+        if (!this->track_peak) {
+            return;
+        }
+
+        auto live = this->_live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+        auto peak = this->_peak.load(std::memory_order_relaxed);
+        while (live > peak && !this->_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void TrackingAllocator::_sub_live(Shard& shard, size_t bytes) noexcept {
+        shard.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        if (this->track_peak) {
+            this->_live.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    AllocationStats TrackingAllocator::stats() const noexcept {
+        AllocationStats stats = {};
+        for (auto& shard : this->_shards) {
+            stats.allocs += shard.allocs.load(std::memory_order_relaxed);
+            stats.frees += shard.frees.load(std::memory_order_relaxed);
+            stats.resizes += shard.resizes.load(std::memory_order_relaxed);
+            stats.failures += shard.failures.load(std::memory_order_relaxed);
+            stats.alloc_ns += shard.alloc_ns.load(std::memory_order_relaxed);
+            stats.free_ns += shard.free_ns.load(std::memory_order_relaxed);
+            stats.live_bytes += shard.live_bytes.load(std::memory_order_relaxed);
+
+            auto max_alloc_ns = shard.max_alloc_ns.load(std::memory_order_relaxed);
+            if (max_alloc_ns > stats.max_alloc_ns) {
+                stats.max_alloc_ns = max_alloc_ns;
+            }
+
+            for (size_t i = 0; i < AllocationStats::histogram_buckets; i++) {
+                stats.histogram[i] += shard.histogram[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        stats.peak_bytes = this->_peak.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    Array<uint8_t> TrackingAllocator::on_alloc(size_t size, uint32_t align) {
+        auto& shard = this->_shard();
+        auto start = this->measure_latency ? now_ns() : 0;
+
+        auto allocation = this->ator->on_alloc(size, align);
+
+        if (this->measure_latency) {
+            auto elapsed = now_ns() - start;
+            add(shard.alloc_ns, elapsed);
+            store_max(shard.max_alloc_ns, elapsed);
+        }
+
+        if (allocation.items == nullptr) {
+            add(shard.failures, 1);
+            return allocation;
+        }
+
+        add(shard.allocs, 1);
+        add(shard.histogram[histogram_bucket(size)], 1);
+        this->_add_live(shard, size);
+
+        return { size, allocation.items };
+    }
+
+    Optional<Array<uint8_t>> TrackingAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        auto& shard = this->_shard();
+        auto start = this->measure_latency ? now_ns() : 0;
+
+        auto resized = this->ator->on_resize(buf, buf_align, new_size);
+
+        if (this->measure_latency) {
+            add(shard.alloc_ns, now_ns() - start);
+        }
+
+        if (resized.is_none()) {
+            add(shard.failures, 1);
+            return None;
+        }
+
+        // Growing a null buffer is how List makes its first allocation, so it
+        // counts as one or the frees would outnumber the allocs.
+        auto new_buf = resized.unwrap();
+        add(buf.items == nullptr ? shard.allocs : shard.resizes, 1);
+        add(shard.histogram[histogram_bucket(new_size)], 1);
+        this->_sub_live(shard, buf.len);
+        this->_add_live(shard, new_size);
+
+        return Array{ new_size, new_buf.items };
+    }
+
+    void TrackingAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        if (buf.items == nullptr) {
+            return;
+        }
+
+        auto& shard = this->_shard();
+        auto start = this->measure_latency ? now_ns() : 0;
+
+        this->ator->on_free(buf, buf_align);
+
+        if (this->measure_latency) {
+            add(shard.free_ns, now_ns() - start);
+        }
+
+        add(shard.frees, 1);
+        this->_sub_live(shard, buf.len);
+    }
+}
+
+void sk::Formatter<sk::AllocationStats>::format(const sk::AllocationStats& stats, std::string_view fmt, sk::Writer& writer) {
+    auto format = Format::from(fmt);
+    const char* sep = format.alternate ? "\n\t" : " ";
+    const char* end = format.alternate ? "\n" : " ";
+
+    writer.print("AllocationStats{{{}allocs: {},{}frees: {},{}resizes: {},{}failures: {},",
+        sep, stats.allocs, sep, stats.frees, sep, stats.resizes, sep, stats.failures);
+    writer.print("{}live_bytes: {},{}peak_bytes: {},", sep, stats.live_bytes, sep, stats.peak_bytes);
+
+    auto calls = stats.allocs + stats.resizes;
+    if (calls > 0 && stats.alloc_ns > 0) {
+        writer.print("{}avg_alloc_ns: {},{}max_alloc_ns: {},", sep, stats.alloc_ns / calls, sep, stats.max_alloc_ns);
+    }
+    if (stats.frees > 0 && stats.free_ns > 0) {
+        writer.print("{}avg_free_ns: {},", sep, stats.free_ns / stats.frees);
+    }
+
+    writer.print("{}sizes: [", sep);
+    bool first = true;
+    for (size_t i = 0; i < AllocationStats::histogram_buckets; i++) {
+        if (stats.histogram[i] == 0) {
+            continue;
+        }
+
+        size_t lower = i == 0 ? 0 : size_t{ 1 } << (i - 1);
+        const char* comma = first ? "" : ", ";
+        writer.print("{}{}..: {}", comma, lower, stats.histogram[i]);
+        first = false;
+    }
+
+    writer.print("]{}}}", end);
+}
@@ -0,0 +1,154 @@
+#include "../virtual-arena-allocator.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace sk {
+    static size_t page_size() {
+        static size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    Optional<VirtualArenaAllocator> VirtualArenaAllocator::make(size_t reserve_size, size_t commit_granularity) noexcept {
+        auto granularity = internal::align_forward(commit_granularity > 0 ? commit_granularity : 1, page_size());
+        auto reserved = internal::align_forward(reserve_size, granularity);
+
+        void* base = mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) {
+            return None;
+        }
+
+        VirtualArenaAllocator arena;
+        arena._base = reinterpret_cast<uint8_t*>(base);
+        arena._allocated = 0;
+        arena._committed = 0;
+        arena.reserved = reserved;
+        arena.commit_granularity = granularity;
+
+        return arena;
+    }
+
+    bool VirtualArenaAllocator::_commit(size_t end) noexcept {
+        if (end <= this->_committed) {
+            return true;
+        }
+
+        if (end > this->reserved) {
+            return false;
+        }
+
+        auto new_committed = internal::align_forward(end, this->commit_granularity);
+        if (new_committed > this->reserved) {
+            new_committed = this->reserved;
+        }
+
+        auto start = this->_base + this->_committed;
+        if (mprotect(start, new_committed - this->_committed, PROT_READ | PROT_WRITE) != 0) {
+            return false;
+        }
+
+        this->_committed = new_committed;
+        return true;
+    }
+
+    void VirtualArenaAllocator::_decommit(size_t end) noexcept {
+        auto new_committed = internal::align_forward(end, this->commit_granularity);
+        if (new_committed >= this->_committed) {
+            return;
+        }
+
+        // MADV_DONTNEED hands the physical pages back immediately; dropping the
+        // protection as well keeps the commit charge honest.
+        auto start = this->_base + new_committed;
+        auto len = this->_committed - new_committed;
+        madvise(start, len, MADV_DONTNEED);
+        mprotect(start, len, PROT_NONE);
+
+        this->_committed = new_committed;
+    }
+
+    VirtualArenaAllocator::Mark VirtualArenaAllocator::mark() const noexcept {
+        return { this->_allocated };
+    }
+
+    bool VirtualArenaAllocator::rollback(Mark mark) noexcept {
+        if (mark._index > this->_allocated) {
+            return false;
+        }
+
+        this->_allocated = mark._index;
+        this->_decommit(mark._index);
+        return true;
+    }
+
+    void VirtualArenaAllocator::reset() noexcept {
+        this->rollback({ 0 });
+    }
+
+    void VirtualArenaAllocator::destroy() noexcept {
+        if (this->_base) {
+            munmap(this->_base, this->reserved);
+        }
+
+        this->_base = nullptr;
+        this->_allocated = 0;
+        this->_committed = 0;
+    }
+
+    size_t VirtualArenaAllocator::allocated() const noexcept {
+        return this->_allocated;
+    }
+
+    size_t VirtualArenaAllocator::committed() const noexcept {
+        return this->_committed;
+    }
+
+    Array<uint8_t> VirtualArenaAllocator::on_alloc(size_t size, uint32_t align) {
+        assert(internal::is_power_of_two(align));
+
+        auto base = reinterpret_cast<uintptr_t>(this->_base);
+        auto offset = internal::align_forward(base + this->_allocated, align) - base;
+        if (offset + size < offset || !this->_commit(offset + size)) {
+            return { 0, nullptr };
+        }
+
+        this->_allocated = offset + size;
+        return { size, this->_base + offset };
+    }
+
+    Optional<Array<uint8_t>> VirtualArenaAllocator::on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) {
+        // The last allocation borders uncommitted address space so it only ever
+        // has to commit more pages, never move.
+        if (buf.items && buf.items + buf.len == this->_base + this->_allocated) {
+            auto offset = static_cast<size_t>(buf.items - this->_base);
+            if (new_size > this->reserved - offset || !this->_commit(offset + new_size)) {
+                return None;
+            }
+
+            this->_allocated = offset + new_size;
+            buf.len = new_size;
+            return buf;
+        }
+
+        if (new_size <= buf.len) {
+            buf.len = new_size;
+            return buf;
+        }
+
+        auto new_allocation = this->on_alloc(new_size, buf_align);
+        if (new_allocation.items == nullptr) {
+            return None;
+        }
+
+        if (buf.len > 0) {
+            memcpy(new_allocation.items, buf.items, buf.len);
+        }
+
+        return new_allocation;
+    }
+
+    void VirtualArenaAllocator::on_free(Array<uint8_t> buf, uint32_t buf_align) {
+        // Like ArenaAllocator, memory is only given back by `rollback()` or `destroy()`
+    }
+}
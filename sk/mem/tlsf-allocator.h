@@ -0,0 +1,80 @@
+#pragma once
+
+#include "allocator.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sk {
+    // Two-Level Segregated Fit allocator over a fixed pool. Free blocks are
+    // binned by size into a first level of powers of two, each subdivided
+    // linearly into `sl_index_count` second level lists, with a bitmap per
+    // level. Finding a fit is a pair of find-first-set operations and freeing
+    // merges with both physical neighbours in constant time, so `on_alloc`,
+    // `on_free` and in-place `on_resize` have a hard O(1) bound regardless of
+    // pool state.
+    struct TLSFAllocator : Allocator {
+        // === Constants ===
+        static constexpr size_t align_size_log2 = 3;
+        static constexpr size_t align_size = size_t{ 1 } << align_size_log2;
+        static constexpr size_t sl_index_count_log2 = 5;
+        static constexpr size_t sl_index_count = size_t{ 1 } << sl_index_count_log2;
+        static constexpr size_t fl_index_max = 38;
+        static constexpr size_t fl_index_shift = sl_index_count_log2 + align_size_log2;
+        static constexpr size_t fl_index_count = fl_index_max - fl_index_shift + 1;
+        static constexpr size_t small_block_size = size_t{ 1 } << fl_index_shift;
+
+        // === Structures ===
+        // `prev_phys` overlaps the last word of the previous block and is only
+        // valid while that block is free. `next_free`/`prev_free` overlap the
+        // payload and are only valid while this block is free.
+        struct Block {
+            Block* prev_phys;
+            size_t size; // low bits: 1 = this block free, 2 = previous block free
+            Block* next_free;
+            Block* prev_free;
+        };
+
+        // === Data ===
+        uint32_t _fl_bitmap;
+        uint32_t _sl_bitmap[fl_index_count];
+        Block* _blocks[fl_index_count][sl_index_count];
+        Array<uint8_t> _pool;
+        bool _owns_pool;
+        Allocator* ator;
+
+        // === Constructors / Assignments ===
+        TLSFAllocator() noexcept = default;
+        TLSFAllocator(const TLSFAllocator&) noexcept = default;
+        TLSFAllocator(TLSFAllocator&&) noexcept = default;
+
+        TLSFAllocator& operator=(const TLSFAllocator&) noexcept = default;
+        TLSFAllocator& operator=(TLSFAllocator&&) noexcept = default;
+
+        // Takes a pool of `pool_size` bytes from `allocator`.
+        static Optional<TLSFAllocator> make(Allocator* allocator, size_t pool_size) noexcept;
+
+        // Manages caller-provided memory, e.g. a static buffer. It must outlive the allocator.
+        static Optional<TLSFAllocator> make(Array<uint8_t> memory) noexcept;
+
+        // === Associated Functions ===
+        void _init(Array<uint8_t> memory) noexcept;
+        void _insert_free_block(Block* block) noexcept;
+        void _remove_free_block(Block* block) noexcept;
+        Block* _locate_free(size_t size) noexcept;
+        Block* _merge_prev(Block* block) noexcept;
+        Block* _merge_next(Block* block) noexcept;
+        void _trim_free(Block* block, size_t size) noexcept;
+        void _trim_used(Block* block, size_t size) noexcept;
+        Block* _trim_free_leading(Block* block, size_t size) noexcept;
+        uint8_t* _alloc(size_t size, uint32_t align) noexcept;
+        void _free(uint8_t* ptr) noexcept;
+        size_t free_bytes() const noexcept;
+        void destroy() noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "allocator.h"
+#include "../fmt.h"
+
+#include <stdint.h>
+#include <atomic>
+
+namespace sk {
+    // Snapshot of a TrackingAllocator's counters.
+    struct AllocationStats {
+        // Bucket `i` counts requests of [2^(i-1), 2^i) bytes, bucket 0 counts empty ones.
+        static constexpr size_t histogram_buckets = 40;
+
+        size_t allocs;
+        size_t frees;
+        size_t resizes;
+        size_t failures;
+        size_t live_bytes;
+        size_t peak_bytes;
+        size_t histogram[histogram_buckets];
+        uint64_t alloc_ns;
+        uint64_t free_ns;
+        uint64_t max_alloc_ns;
+    };
+
+    // Wraps another allocator and counts everything that goes through it.
+    // Allocations are handed out at exactly the requested size, even when
+    // `ator` returns more, so live bytes come back to zero whichever length
+    // in the allowed range the caller frees with.
+    //
+    // Counters, live bytes included, are spread over cache-line sized shards
+    // that threads pick once, so concurrent threads rarely touch the same line
+    // and no lock is ever taken. An exact peak needs one counter every thread
+    // updates, so it is only kept when `track_peak` is set; otherwise
+    // peak_bytes reads 0. Latency is measured with the steady clock and can be
+    // switched off to shave two clock reads off every call.
+    struct TrackingAllocator : Allocator {
+        // === Structures ===
+        static constexpr size_t shard_count = 16;
+
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> allocs;
+            std::atomic<uint64_t> frees;
+            std::atomic<uint64_t> resizes;
+            std::atomic<uint64_t> failures;
+            std::atomic<uint64_t> alloc_ns;
+            std::atomic<uint64_t> free_ns;
+            std::atomic<uint64_t> max_alloc_ns;
+            std::atomic<uint64_t> live_bytes; // wraps when other shards free what this one allocated, the sum is still right
+            std::atomic<uint64_t> histogram[AllocationStats::histogram_buckets];
+        };
+
+        // === Data ===
+        Allocator* ator;
+        bool measure_latency;
+        bool track_peak;
+        std::atomic<size_t> _live; // only kept with `track_peak`
+        std::atomic<size_t> _peak;
+        Shard _shards[shard_count];
+
+        // === Constructors / Assignments ===
+        TrackingAllocator(Allocator* allocator, bool measure_latency = true, bool track_peak = false) noexcept;
+        TrackingAllocator(const TrackingAllocator&) = delete;
+        TrackingAllocator(TrackingAllocator&&) = delete;
+
+        TrackingAllocator& operator=(const TrackingAllocator&) = delete;
+        TrackingAllocator& operator=(TrackingAllocator&&) = delete;
+
+        // === Associated Functions ===
+        Shard& _shard() noexcept;
+        void _add_live(Shard& shard, size_t bytes) noexcept;
+        void _sub_live(Shard& shard, size_t bytes) noexcept;
+        AllocationStats stats() const noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+
+    template<> struct Formatter<AllocationStats> {
+        static void format(const AllocationStats& stats, std::string_view fmt, Writer& writer);
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "allocator.h"
+
+#include <stdint.h>
+
+namespace sk {
+    // Arena over a single contiguous range of reserved address space. Pages are
+    // only committed once the bump pointer reaches them, so the reservation can
+    // be far larger than what is ever used and the last allocation can always be
+    // grown in place.
+    struct VirtualArenaAllocator : Allocator {
+        // === Structures ===
+        struct Mark {
+            size_t _index;
+        };
+
+        // === Data ===
+        uint8_t* _base;
+        size_t _allocated;
+        size_t _committed;
+        size_t reserved;
+        size_t commit_granularity;
+
+        // === Constructors / Assignments ===
+        VirtualArenaAllocator() noexcept = default;
+        VirtualArenaAllocator(const VirtualArenaAllocator&) noexcept = default;
+        VirtualArenaAllocator(VirtualArenaAllocator&&) noexcept = default;
+
+        VirtualArenaAllocator& operator=(const VirtualArenaAllocator&) noexcept = default;
+        VirtualArenaAllocator& operator=(VirtualArenaAllocator&&) noexcept = default;
+
+        static Optional<VirtualArenaAllocator> make(size_t reserve_size, size_t commit_granularity = 64 * 1024) noexcept;
+
+        // === Associated Functions ===
+        bool _commit(size_t end) noexcept;
+        void _decommit(size_t end) noexcept;
+        Mark mark() const noexcept;
+        bool rollback(Mark mark) noexcept;
+        void reset() noexcept;
+        void destroy() noexcept;
+
+        size_t allocated() const noexcept;
+        size_t committed() const noexcept;
+
+        // === Inherited Functions ===
+        Array<uint8_t> on_alloc(size_t size, uint32_t align) override;
+        Optional<Array<uint8_t>> on_resize(Array<uint8_t> buf, uint32_t buf_align, size_t new_size) override;
+        void on_free(Array<uint8_t> buf, uint32_t buf_align) override;
+    };
+}
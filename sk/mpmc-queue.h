@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "array.h"
+
+namespace sk {
+    // Bounded lock-free queue for any number of producers and consumers,
+    // after Dmitry Vyukov's design. Each cell carries a sequence number that
+    // says whose turn it is: a producer may fill cell `pos` once its sequence
+    // is `pos`, a consumer may empty it once it is `pos + 1`, and emptying
+    // hands it to the producer one lap later. Producers and consumers each
+    // claim positions with a compare-and-swap on their own cache line, and
+    // batches claim a whole run of cells with a single one.
+    //
+    // `init` and `destroy` must not race with pushes or pops.
+    template<typename T, typename A = Allocator>
+    struct MpmcQueue {
+        // === Structures ===
+        struct Cell {
+            std::atomic<size_t> sequence;
+            alignas(T) uint8_t storage[sizeof(T)];
+
+            T* item() noexcept {
+                return reinterpret_cast<T*>(this->storage);
+            }
+        };
+
+        // === Data ===
+        alignas(64) std::atomic<size_t> _enqueue_pos;
+        alignas(64) std::atomic<size_t> _dequeue_pos;
+
+        // Fixed after `init`
+        alignas(64) size_t capacity;
+        Cell* _cells;
+
+        // === Constructors / Assignments ===
+        MpmcQueue() noexcept : _enqueue_pos(0), _dequeue_pos(0), capacity(0), _cells(nullptr) {}
+        MpmcQueue(const MpmcQueue<T, A>&) = delete;
+        MpmcQueue(MpmcQueue<T, A>&&) = delete;
+
+        MpmcQueue<T, A>& operator=(const MpmcQueue<T, A>&) = delete;
+        MpmcQueue<T, A>& operator=(MpmcQueue<T, A>&&) = delete;
+
+        // === Associated Functions ===
+
+        // Allocates room for at least `min_capacity` items, rounded up to a
+        // power of two of at least 2.
+        bool init(A& ator, size_t min_capacity) noexcept {
+            auto capacity = size_t{ 2 };
+            while (capacity < min_capacity) {
+                capacity *= 2;
+            }
+
+            auto cells = ator.template alloc<Cell>(capacity);
+            if (cells.items == nullptr) {
+                return false;
+            }
+
+            for (size_t i = 0; i < capacity; i++) {
+                new (&cells.items[i].sequence) std::atomic<size_t>(i);
+            }
+
+            this->capacity = capacity;
+            this->_cells = cells.items;
+            return true;
+        }
+
+        // Destroys whatever is still queued and frees the ring.
+        void destroy(A& ator) noexcept {
+            while (this->pop().is_some()) {}
+
+            if (this->_cells != nullptr) {
+                ator.free(this->capacity, this->_cells);
+            }
+
+            this->capacity = 0;
+            this->_cells = nullptr;
+        }
+
+        // Only exact when no thread is pushing or popping.
+        size_t size_approx() const noexcept {
+            auto enqueued = this->_enqueue_pos.load(std::memory_order_relaxed);
+            auto dequeued = this->_dequeue_pos.load(std::memory_order_relaxed);
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+
+        // Claims up to `wanted` consecutive cells whose sequence is `pos + i +
+        // offset`, advancing `position` past them. Returns the first claimed
+        // position and sets `*claimed`, which is 0 when the queue is full (for
+        // producers) or empty (for consumers).
+        size_t _claim(std::atomic<size_t>& position, size_t offset, size_t wanted, size_t* claimed) noexcept {
+            auto mask = this->capacity - 1;
+            auto pos = position.load(std::memory_order_relaxed);
+            while (true) {
+                auto seq = this->_cells[pos & mask].sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + offset);
+                if (diff < 0) {
+                    *claimed = 0;
+                    return pos;
+                }
+
+                if (diff > 0) {
+                    // Another thread already took `pos`
+                    pos = position.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                size_t count = 1;
+                while (count < wanted && count < this->capacity) {
+                    auto next = this->_cells[(pos + count) & mask].sequence.load(std::memory_order_acquire);
+                    if (next != pos + count + offset) {
+                        break;
+                    }
+                    count++;
+                }
+
+                if (position.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                    *claimed = count;
+                    return pos;
+                }
+            }
+        }
+
+        // Returns false when the queue is full.
+        template<typename... Args>
+        bool emplace(Args&&... args) noexcept {
+            size_t claimed;
+            auto pos = this->_claim(this->_enqueue_pos, 0, 1, &claimed);
+            if (claimed == 0) {
+                return false;
+            }
+
+            auto& cell = this->_cells[pos & (this->capacity - 1)];
+            new (cell.item()) T(std::forward<Args>(args)...);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool push(const T& item) noexcept {
+            return this->emplace(item);
+        }
+
+        bool push(T&& item) noexcept {
+            return this->emplace(std::move(item));
+        }
+
+        // Copies as many of `items` as fit into consecutive cells and returns
+        // how many that was.
+        size_t push_n(Array<T> items) noexcept {
+            if (items.len == 0) {
+                return 0;
+            }
+
+            size_t claimed;
+            auto pos = this->_claim(this->_enqueue_pos, 0, items.len, &claimed);
+
+            auto mask = this->capacity - 1;
+            for (size_t i = 0; i < claimed; i++) {
+                auto& cell = this->_cells[(pos + i) & mask];
+                new (cell.item()) T(items.items[i]);
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+
+            return claimed;
+        }
+
+        // None when the queue is empty.
+        Optional<T> pop() noexcept {
+            size_t claimed;
+            auto pos = this->_claim(this->_dequeue_pos, 1, 1, &claimed);
+            if (claimed == 0) {
+                return None;
+            }
+
+            auto& cell = this->_cells[pos & (this->capacity - 1)];
+            T item(std::move(*cell.item()));
+            cell.item()->~T();
+            cell.sequence.store(pos + this->capacity, std::memory_order_release);
+            return item;
+        }
+
+        // Moves up to `out.len` items into `out`, whose items must already be
+        // constructed, and returns how many it moved.
+        size_t pop_n(Array<T> out) noexcept {
+            if (out.len == 0) {
+                return 0;
+            }
+
+            size_t claimed;
+            auto pos = this->_claim(this->_dequeue_pos, 1, out.len, &claimed);
+
+            auto mask = this->capacity - 1;
+            for (size_t i = 0; i < claimed; i++) {
+                auto& cell = this->_cells[(pos + i) & mask];
+                out.items[i] = std::move(*cell.item());
+                cell.item()->~T();
+                cell.sequence.store(pos + i + this->capacity, std::memory_order_release);
+            }
+
+            return claimed;
+        }
+    };
+}
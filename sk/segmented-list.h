@@ -0,0 +1,349 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "mem/relocate.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+
+namespace sk {
+    // A list that never moves its items. It grows by adding chunks rather than
+    // reallocating, so pointers to items stay valid until the item is removed
+    // or the list destroyed. Chunk `k` holds `16 << k` items, which keeps the
+    // number of chunks logarithmic and lets an index be split into chunk and
+    // offset with one count-leading-zeros instead of a search.
+    //
+    // Iterate with `chunks()` to get each run of items as a contiguous Array
+    // the compiler can vectorize over.
+    template<typename T, typename A = Allocator>
+    struct SegmentedList {
+        // === Constants ===
+        static constexpr size_t first_chunk_shift = 4;
+        static constexpr size_t first_chunk_len = size_t{ 1 } << first_chunk_shift;
+        static constexpr size_t max_chunks = 64 - first_chunk_shift;
+
+        // === Structures ===
+        struct Iterator {
+            const SegmentedList<T, A>* list;
+            size_t index;
+            size_t chunk;
+            T* ptr;
+            T* chunk_end;
+
+            T& operator*() const noexcept {
+                return *this->ptr;
+            }
+
+            T* operator->() const noexcept {
+                return this->ptr;
+            }
+
+            Iterator& operator++() noexcept {
+                this->index++;
+                this->ptr++;
+                if (this->ptr == this->chunk_end && this->index < this->list->len) {
+                    this->chunk++;
+                    auto items = this->list->chunk(this->chunk);
+                    this->ptr = items.items;
+                    this->chunk_end = items.items + items.len;
+                }
+                return *this;
+            }
+
+            bool operator!=(const Iterator& other) const noexcept {
+                return this->index != other.index;
+            }
+        };
+
+        struct ChunkIterator {
+            const SegmentedList<T, A>* list;
+            size_t chunk;
+
+            Array<T> operator*() const noexcept {
+                return this->list->chunk(this->chunk);
+            }
+
+            ChunkIterator& operator++() noexcept {
+                this->chunk++;
+                return *this;
+            }
+
+            bool operator!=(const ChunkIterator& other) const noexcept {
+                return this->chunk != other.chunk;
+            }
+        };
+
+        struct Chunks {
+            const SegmentedList<T, A>* list;
+
+            ChunkIterator begin() const noexcept {
+                return { this->list, 0 };
+            }
+
+            ChunkIterator end() const noexcept {
+                return { this->list, this->list->_used_chunks() };
+            }
+        };
+
+        // === Data ===
+        size_t len;
+        size_t chunk_count; // allocated chunks
+        T* _chunks[max_chunks];
+        size_t _chunk_alloc_lens[max_chunks]; // items the allocator returned for each chunk
+
+        // === Constructors / Assignments ===
+        SegmentedList() noexcept : len(0), chunk_count(0) {
+            memset(this->_chunks, 0, sizeof(this->_chunks));
+            memset(this->_chunk_alloc_lens, 0, sizeof(this->_chunk_alloc_lens));
+        }
+
+        SegmentedList(const SegmentedList<T, A>&) noexcept = default;
+        SegmentedList(SegmentedList<T, A>&&) noexcept = default;
+
+        SegmentedList<T, A>& operator=(const SegmentedList<T, A>&) noexcept = default;
+        SegmentedList<T, A>& operator=(SegmentedList<T, A>&&) noexcept = default;
+
+        // === Layout ===
+        static size_t _chunk_len(size_t chunk) noexcept {
+            return first_chunk_len << chunk;
+        }
+
+        // Index of the first item in `chunk`.
+        static size_t _chunk_start(size_t chunk) noexcept {
+            return first_chunk_len * ((size_t{ 1 } << chunk) - 1);
+        }
+
+        // Chunk `k` starts at 16 * (2^k - 1), so `index + 16` has its top bit
+        // at position `k + 4` and the bits below it are the offset.
+        static size_t _chunk_of(size_t index) noexcept {
+            auto biased = index + first_chunk_len;
+            return static_cast<size_t>(63 - __builtin_clzll(biased)) - first_chunk_shift;
+        }
+
+        // === Associated Functions ===
+        size_t size() const noexcept {
+            return this->len;
+        }
+
+        size_t capacity() const noexcept {
+            return SegmentedList::_chunk_start(this->chunk_count);
+        }
+
+        T* _slot(size_t index) const noexcept {
+            auto chunk = SegmentedList::_chunk_of(index);
+            return &this->_chunks[chunk][index - SegmentedList::_chunk_start(chunk)];
+        }
+
+        T& operator[](size_t index) const noexcept {
+            assert(index < this->len);
+            return *this->_slot(index);
+        }
+
+        Optional<T&> at(size_t index) const noexcept {
+            if (index >= this->len) {
+                return None;
+            }
+            return (*this)[index];
+        }
+
+        Optional<T&> first() const noexcept {
+            return this->at(0);
+        }
+
+        Optional<T&> last() const noexcept {
+            return this->at(this->len - 1);
+        }
+
+        size_t _used_chunks() const noexcept {
+            return this->len == 0 ? 0 : SegmentedList::_chunk_of(this->len - 1) + 1;
+        }
+
+        // The live items of `chunk`, which may be fewer than it holds.
+        Array<T> chunk(size_t chunk) const noexcept {
+            auto start = SegmentedList::_chunk_start(chunk);
+            if (chunk >= this->chunk_count || start >= this->len) {
+                return {};
+            }
+
+            auto live = this->len - start;
+            auto chunk_len = SegmentedList::_chunk_len(chunk);
+            return { live < chunk_len ? live : chunk_len, this->_chunks[chunk] };
+        }
+
+        Chunks chunks() const noexcept {
+            return { this };
+        }
+
+        void destroy(A& ator) noexcept {
+            this->clear();
+            for (size_t i = 0; i < this->chunk_count; i++) {
+                ator.free(this->_chunk_alloc_lens[i], this->_chunks[i]);
+            }
+
+            *this = SegmentedList<T, A>{};
+        }
+
+        // Destroys every item but keeps the chunks for reuse.
+        void clear() noexcept {
+            for (auto items : this->chunks()) {
+                destroy_range(items.items, items.len);
+            }
+            this->len = 0;
+        }
+
+        // Adds chunks until there are at least `min_capacity` slots.
+        bool reserve(A& ator, size_t min_capacity) noexcept {
+            while (this->capacity() < min_capacity) {
+                if (this->chunk_count == max_chunks) {
+                    return false;
+                }
+
+                auto chunk = ator.template alloc<T>(SegmentedList::_chunk_len(this->chunk_count));
+                if (chunk.items == nullptr) {
+                    return false;
+                }
+
+                this->_chunks[this->chunk_count] = chunk.items;
+                this->_chunk_alloc_lens[this->chunk_count] = chunk.len;
+                this->chunk_count++;
+            }
+            return true;
+        }
+
+        // Constructs a new last item in place. Existing items never move, so
+        // `args` may refer to one of them.
+        template<typename... Args>
+        bool emplace(A& ator, Args&&... args) noexcept {
+            if (!this->reserve(ator, this->len + 1)) {
+                return false;
+            }
+
+            new (this->_slot(this->len)) T(std::forward<Args>(args)...);
+            this->len++;
+            return true;
+        }
+
+        bool append(A& ator, const T& item) noexcept {
+            return this->emplace(ator, item);
+        }
+
+        bool append(A& ator, T&& item) noexcept {
+            return this->emplace(ator, std::move(item));
+        }
+
+        // Appends copies of all of `items`, filling each chunk with one block copy.
+        bool extend(A& ator, Array<T> items) noexcept {
+            if (!this->reserve(ator, this->len + items.len)) {
+                return false;
+            }
+
+            size_t copied = 0;
+            while (copied < items.len) {
+                auto chunk = SegmentedList::_chunk_of(this->len);
+                auto room = SegmentedList::_chunk_start(chunk + 1) - this->len;
+                auto count = items.len - copied < room ? items.len - copied : room;
+
+                auto dst = this->_slot(this->len);
+                auto src = &items.items[copied];
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    memcpy(dst, src, count * sizeof(T));
+                } else {
+                    for (size_t i = 0; i < count; i++) {
+                        new (&dst[i]) T(src[i]);
+                    }
+                }
+
+                this->len += count;
+                copied += count;
+            }
+            return true;
+        }
+
+        // Removes the last item. Every other item keeps its address.
+        Optional<T> pop() noexcept {
+            if (this->len == 0) {
+                return None;
+            }
+
+            auto& slot = (*this)[this->len - 1];
+            T item(std::move(slot));
+            slot.~T();
+
+            this->len--;
+            return item;
+        }
+
+        // === Iterator Stuff ===
+        Iterator begin() const noexcept {
+            auto items = this->chunk(0);
+            return { this, 0, 0, items.items, items.items + items.len };
+        }
+
+        Iterator end() const noexcept {
+            return { this, this->len, 0, nullptr, nullptr };
+        }
+    };
+
+    template<typename T, typename A>
+    struct Formatter<SegmentedList<T, A>> {
+        static void format(const SegmentedList<T, A>& list, std::string_view fmt, Writer& writer) {
+            bool alternate = fmt == "#";
+            writer.write_string("[");
+            size_t i = 0;
+            for (auto& item : list) {
+                writer.print("{}{}", alternate ? "\n\t" : "", item);
+                if (++i < list.len) {
+                    writer.print(",{}", alternate ? "" : " ");
+                }
+            }
+            writer.print("{}]", alternate ? "\n" : "");
+        }
+    };
+
+    template<typename T, typename A>
+    struct Owned<SegmentedList<T, A>> : public IOwned<SegmentedList<T, A>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<SegmentedList<T, A>>(), allocator(allocator) {}
+        Owned(const Owned<SegmentedList<T, A>>&) noexcept = default;
+        Owned(Owned<SegmentedList<T, A>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool reserve(size_t min_capacity) noexcept {
+            return this->as_ref().reserve(allocator, min_capacity);
+        }
+
+        bool append(const T& item) noexcept {
+            return this->as_ref().append(allocator, item);
+        }
+
+        bool append(T&& item) noexcept {
+            return this->as_ref().append(allocator, std::move(item));
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args) noexcept {
+            return this->as_ref().emplace(allocator, std::forward<Args>(args)...);
+        }
+
+        bool extend(Array<T> items) noexcept {
+            return this->as_ref().extend(allocator, items);
+        }
+    };
+
+    template<typename T, typename A = Allocator>
+    using OwnedSegmentedList = Owned<SegmentedList<T, A>>;
+}
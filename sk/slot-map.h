@@ -0,0 +1,268 @@
+#pragma once
+
+#include <stdint.h>
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+#include "list.h"
+
+namespace sk {
+    // Names a value in a SlotMap. The generation changes every time a slot is
+    // reused, so a handle to a removed value never finds its replacement.
+    struct SlotHandle {
+        uint32_t index;
+        uint32_t generation;
+
+        uint64_t to_bits() const noexcept {
+            return (static_cast<uint64_t>(this->generation) << 32) | this->index;
+        }
+
+        static SlotHandle from_bits(uint64_t bits) noexcept {
+            return { static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32) };
+        }
+
+        friend bool operator==(const SlotHandle& a, const SlotHandle& b) noexcept {
+            return a.index == b.index && a.generation == b.generation;
+        }
+
+        friend bool operator!=(const SlotHandle& a, const SlotHandle& b) noexcept {
+            return !(a == b);
+        }
+    };
+
+    // Stores values densely in insertion order (until removals swap the last
+    // value into the hole) and hands out SlotHandles to them. Insert, remove
+    // and lookup are O(1), and iterating `values()` walks one contiguous
+    // array of live values only.
+    //
+    // Each slot's generation is odd while it holds a value and even while it
+    // is free. A slot whose generation would wrap around is retired instead of
+    // reused, so stale handles can never match.
+    template<typename T, typename A = Allocator>
+    struct SlotMap {
+        // === Structures ===
+        struct Slot {
+            uint32_t generation;
+            uint32_t dense_or_next; // index into the values when live, next free slot otherwise
+        };
+
+        // === Constants ===
+        static constexpr uint32_t no_slot = UINT32_MAX;
+
+        // === Data ===
+        List<T, A> _values;
+        List<uint32_t, A> _dense_to_slot;
+        List<Slot, A> _slots;
+        uint32_t _free_head;
+
+        // === Constructors / Assignments ===
+        SlotMap() noexcept : _free_head(no_slot) {}
+        SlotMap(const SlotMap<T, A>&) noexcept = default;
+        SlotMap(SlotMap<T, A>&&) noexcept = default;
+
+        SlotMap<T, A>& operator=(const SlotMap<T, A>&) noexcept = default;
+        SlotMap<T, A>& operator=(SlotMap<T, A>&&) noexcept = default;
+
+        // === Associated Functions ===
+        size_t size() const noexcept {
+            return this->_values.len;
+        }
+
+        // The live values, densely packed. Any insert or remove may reorder or
+        // move them.
+        Array<T> values() const noexcept {
+            return this->_values;
+        }
+
+        // The handle of the value at `dense_index` in `values()`.
+        SlotHandle handle_at(size_t dense_index) const noexcept {
+            auto index = this->_dense_to_slot[dense_index];
+            return { index, this->_slots[index].generation };
+        }
+
+        // The slot `handle` names if it still holds a value, null otherwise.
+        Slot* _live_slot(SlotHandle handle) const noexcept {
+            if (handle.index >= this->_slots.len) {
+                return nullptr;
+            }
+
+            auto slot = &this->_slots.items[handle.index];
+            if (slot->generation != handle.generation || (slot->generation & 1) == 0) {
+                return nullptr;
+            }
+            return slot;
+        }
+
+        bool contains(SlotHandle handle) const noexcept {
+            return this->_live_slot(handle) != nullptr;
+        }
+
+        // None if `handle` was never valid or its value has been removed.
+        Optional<T&> get(SlotHandle handle) const noexcept {
+            auto slot = this->_live_slot(handle);
+            if (slot == nullptr) {
+                return None;
+            }
+            return this->_values.items[slot->dense_or_next];
+        }
+
+        // Makes room for `count` values in total without growing.
+        bool reserve(A& ator, size_t count) noexcept {
+            return this->_values.reserve(ator, count)
+                && this->_dense_to_slot.reserve(ator, count)
+                && this->_slots.reserve(ator, count);
+        }
+
+        template<typename... Args>
+        Optional<SlotHandle> emplace(A& ator, Args&&... args) noexcept {
+            // Grow everything first so a failure leaves the map untouched
+            if (!this->_values._reserve_more(ator, 1) || !this->_dense_to_slot._reserve_more(ator, 1)) {
+                return None;
+            }
+
+            uint32_t index;
+            if (this->_free_head != no_slot) {
+                index = this->_free_head;
+                this->_free_head = this->_slots[index].dense_or_next;
+            } else {
+                if (this->_slots.len == no_slot || !this->_slots.append(ator, Slot{ 0, 0 })) {
+                    return None;
+                }
+                index = static_cast<uint32_t>(this->_slots.len - 1);
+            }
+
+            auto& slot = this->_slots[index];
+            slot.generation++;
+            slot.dense_or_next = static_cast<uint32_t>(this->_values.len);
+
+            this->_values.emplace(ator, std::forward<Args>(args)...);
+            this->_dense_to_slot.append(ator, index);
+
+            return SlotHandle{ index, slot.generation };
+        }
+
+        Optional<SlotHandle> insert(A& ator, const T& value) noexcept {
+            // `value` may live in this map, so copy it out before growing.
+            T copy(value);
+            return this->emplace(ator, std::move(copy));
+        }
+
+        Optional<SlotHandle> insert(A& ator, T&& value) noexcept {
+            return this->emplace(ator, std::move(value));
+        }
+
+        // Returns false if `handle` is stale. The last value moves into the gap.
+        bool remove(SlotHandle handle) noexcept {
+            auto live = this->_live_slot(handle);
+            if (live == nullptr) {
+                return false;
+            }
+
+            auto& slot = *live;
+            auto dense = slot.dense_or_next;
+
+            this->_values.swap_remove(dense);
+            this->_dense_to_slot.swap_remove(dense);
+            if (dense < this->_values.len) {
+                this->_slots[this->_dense_to_slot[dense]].dense_or_next = dense;
+            }
+
+            slot.generation++;
+            if (slot.generation != 0) {
+                slot.dense_or_next = this->_free_head;
+                this->_free_head = handle.index;
+            }
+
+            return true;
+        }
+
+        // Removes every value. Handles given out so far all become stale.
+        void clear() noexcept {
+            destroy_range(this->_values.items, this->_values.len);
+            this->_values.len = 0;
+            this->_dense_to_slot.len = 0;
+
+            this->_free_head = no_slot;
+            for (size_t i = this->_slots.len; i > 0; i--) {
+                auto& slot = this->_slots[i - 1];
+                if (slot.generation & 1) {
+                    slot.generation++;
+                }
+                if (slot.generation != 0) {
+                    slot.dense_or_next = this->_free_head;
+                    this->_free_head = static_cast<uint32_t>(i - 1);
+                }
+            }
+        }
+
+        void destroy(A& ator) noexcept {
+            this->_values.destroy(ator);
+            this->_dense_to_slot.destroy(ator);
+            this->_slots.destroy(ator);
+            this->_free_head = no_slot;
+        }
+
+        // === Iterator Stuff ===
+        T* begin() const noexcept {
+            return this->_values.items;
+        }
+
+        T* end() const noexcept {
+            return this->_values.items + this->_values.len;
+        }
+    };
+
+    template<> struct Formatter<SlotHandle> {
+        static void format(const SlotHandle& handle, std::string_view fmt, Writer& writer) {
+            writer.print("SlotHandle{{ index: {}, generation: {} }}", handle.index, handle.generation);
+        }
+    };
+
+    template<typename T, typename A>
+    struct Formatter<SlotMap<T, A>> {
+        static void format(const SlotMap<T, A>& map, std::string_view fmt, Writer& writer) {
+            Formatter<Array<T>>::format(map.values(), fmt, writer);
+        }
+    };
+
+    template<typename T, typename A>
+    struct Owned<SlotMap<T, A>> : public IOwned<SlotMap<T, A>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<SlotMap<T, A>>(), allocator(allocator) {}
+        Owned(const Owned<SlotMap<T, A>>&) noexcept = default;
+        Owned(Owned<SlotMap<T, A>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        bool reserve(size_t count) noexcept {
+            return this->as_ref().reserve(allocator, count);
+        }
+
+        template<typename... Args>
+        Optional<SlotHandle> emplace(Args&&... args) noexcept {
+            return this->as_ref().emplace(allocator, std::forward<Args>(args)...);
+        }
+
+        Optional<SlotHandle> insert(const T& value) noexcept {
+            return this->as_ref().insert(allocator, value);
+        }
+
+        Optional<SlotHandle> insert(T&& value) noexcept {
+            return this->as_ref().insert(allocator, std::move(value));
+        }
+    };
+
+    template<typename T, typename A = Allocator>
+    using OwnedSlotMap = Owned<SlotMap<T, A>>;
+}
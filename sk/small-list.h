@@ -0,0 +1,341 @@
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "mem/relocate.h"
+#include "ptr/owned.h"
+#include "fmt.h"
+#include "array.h"
+
+namespace sk {
+    // A List that keeps its first `N` items inline and only goes to the
+    // allocator once it outgrows them. The allocator is still passed to every
+    // operation that may grow, so a SmallList that never spills never touches
+    // it.
+    //
+    // Copies are shallow like List's once spilled, sharing the heap buffer,
+    // while inline items are copied since they live in the list itself.
+    template<typename T, size_t N, typename A = Allocator>
+    struct SmallList {
+        static_assert(N > 0, "SmallList needs at least one inline slot, use List otherwise");
+
+        // === Data ===
+        size_t capacity; // N while inline
+        size_t len;
+        union {
+            T* _heap;
+            alignas(T) uint8_t _inline[N * sizeof(T)];
+        };
+
+        // === Constructors / Assignments ===
+        SmallList() noexcept : capacity(N), len(0) {}
+
+        SmallList(const SmallList<T, N, A>& other) noexcept {
+            this->_assign(other);
+        }
+
+        SmallList(SmallList<T, N, A>&& other) noexcept {
+            this->_assign(std::move(other));
+        }
+
+        SmallList<T, N, A>& operator=(const SmallList<T, N, A>& other) noexcept {
+            if (this != &other) {
+                this->_assign(other);
+            }
+            return *this;
+        }
+
+        SmallList<T, N, A>& operator=(SmallList<T, N, A>&& other) noexcept {
+            if (this != &other) {
+                this->_assign(std::move(other));
+            }
+            return *this;
+        }
+
+        // Like List, assignment overwrites without destroying what was there.
+        void _assign(const SmallList<T, N, A>& other) noexcept {
+            this->capacity = other.capacity;
+            this->len = other.len;
+            if (other.is_inline()) {
+                _copy_into(this->data(), other.data(), other.len);
+            } else {
+                this->_heap = other._heap;
+            }
+        }
+
+        // Inline items are relocated and a heap buffer changes hands, leaving `other` empty.
+        void _assign(SmallList<T, N, A>&& other) noexcept {
+            this->capacity = other.capacity;
+            this->len = other.len;
+            if (other.is_inline()) {
+                relocate(this->data(), other.data(), other.len);
+            } else {
+                this->_heap = other._heap;
+            }
+
+            other.capacity = N;
+            other.len = 0;
+        }
+
+        // Copies `src` into uninitialized slots starting at `dst`.
+        static void _copy_into(T* dst, const T* src, size_t count) noexcept {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (count > 0) {
+                    memcpy(dst, src, count * sizeof(T));
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    new (&dst[i]) T(src[i]);
+                }
+            }
+        }
+
+        // === Conversions ===
+        operator Array<T>() const noexcept {
+            return { this->len, this->data() };
+        }
+
+        // === Associated Functions ===
+        bool is_inline() const noexcept {
+            return this->capacity == N;
+        }
+
+        T* data() const noexcept {
+            if (this->is_inline()) {
+                return reinterpret_cast<T*>(const_cast<uint8_t*>(this->_inline));
+            }
+            return this->_heap;
+        }
+
+        size_t size() const noexcept {
+            return this->len;
+        }
+
+        ssize_t ssize() const noexcept {
+            return static_cast<ssize_t>(this->len);
+        }
+
+        T& operator[](size_t index) const noexcept {
+            assert(index < this->len);
+            return this->data()[index];
+        }
+
+        Optional<T&> at(size_t index) const noexcept {
+            if (index >= this->len) {
+                return None;
+            }
+            return this->data()[index];
+        }
+
+        Optional<T&> first() const noexcept {
+            return this->at(0);
+        }
+
+        Optional<T&> last() const noexcept {
+            return this->at(this->len - 1);
+        }
+
+        Array<T> slice(size_t idx, size_t len) const noexcept {
+            assert(idx + len <= this->len);
+            T* ptr = &this->data()[idx];
+            return { len, ptr };
+        }
+
+        void destroy(A& ator) noexcept {
+            destroy_range(this->data(), this->len);
+            if (!this->is_inline()) {
+                ator.free(this->capacity, this->_heap);
+            }
+
+            this->capacity = N;
+            this->len = 0;
+        }
+
+        SmallList<T, N, A> clone(A& ator) const noexcept {
+            SmallList<T, N, A> clone;
+            clone.extend(ator, *this);
+            return clone;
+        }
+
+        // Moves the items to a heap buffer of at least `min_capacity`, adopting
+        // whatever capacity the allocator actually handed out.
+        bool _grow(A& ator, size_t min_capacity) noexcept {
+            if (this->is_inline() || !is_trivially_relocatable_v<T>) {
+                auto buf = ator.template alloc<T>(min_capacity);
+                if (buf.items == nullptr) {
+                    return false;
+                }
+
+                relocate(buf.items, this->data(), this->len);
+                if (!this->is_inline()) {
+                    ator.free(this->capacity, this->_heap);
+                }
+
+                this->capacity = buf.len;
+                this->_heap = buf.items;
+                return true;
+            }
+
+            auto new_items = ator.resize(Array<T>{ this->capacity, this->_heap }, min_capacity);
+            if (new_items.is_none()) {
+                return false;
+            }
+
+            auto buf = new_items.unwrap();
+            this->capacity = buf.len;
+            this->_heap = buf.items;
+            return true;
+        }
+
+        bool _reserve_more(A& ator, size_t additional) noexcept {
+            auto needed = this->len + additional;
+            if (needed <= this->capacity) {
+                return true;
+            }
+
+            auto new_capacity = this->capacity * 2;
+            return this->_grow(ator, new_capacity > needed ? new_capacity : needed);
+        }
+
+        bool reserve(A& ator, size_t min_capacity) noexcept {
+            if (min_capacity <= this->capacity) {
+                return true;
+            }
+            return this->_grow(ator, min_capacity);
+        }
+
+        bool append(A& ator, const T& item) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->data()[this->len++]) T(item);
+                return true;
+            }
+
+            // `item` may live in this list, so copy it out before growing.
+            T copy(item);
+            if (!this->_reserve_more(ator, 1)) {
+                return false;
+            }
+
+            new (&this->data()[this->len++]) T(std::move(copy));
+            return true;
+        }
+
+        bool append(A& ator, T&& item) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->data()[this->len++]) T(std::move(item));
+                return true;
+            }
+
+            // `item` may live in this list, so move it out before growing.
+            T moved(std::move(item));
+            if (!this->_reserve_more(ator, 1)) {
+                return false;
+            }
+
+            new (&this->data()[this->len++]) T(std::move(moved));
+            return true;
+        }
+
+        template<typename... Args>
+        bool emplace(A& ator, Args&&... args) noexcept {
+            if (this->len < this->capacity) {
+                new (&this->data()[this->len++]) T(std::forward<Args>(args)...);
+                return true;
+            }
+
+            // `args` may refer to elements of this list, so build the element before growing.
+            T item(std::forward<Args>(args)...);
+            if (!this->_reserve_more(ator, 1)) {
+                return false;
+            }
+
+            new (&this->data()[this->len++]) T(std::move(item));
+            return true;
+        }
+
+        // Appends copies of all of `items`, which may be part of this list.
+        bool extend(A& ator, Array<T> items) noexcept {
+            auto data = this->data();
+            auto aliased = items.items >= data && items.items < data + this->len;
+            auto offset = aliased ? static_cast<size_t>(items.items - data) : 0;
+
+            if (!this->_reserve_more(ator, items.len)) {
+                return false;
+            }
+
+            data = this->data();
+            _copy_into(&data[this->len], aliased ? data + offset : items.items, items.len);
+
+            this->len += items.len;
+            return true;
+        }
+
+        // === Iterator Stuff ===
+        T* begin() const noexcept {
+            return this->data();
+        }
+
+        T* end() const noexcept {
+            return this->data() + this->len;
+        }
+    };
+
+    template<typename T, size_t N, typename A>
+    struct Formatter<SmallList<T, N, A>> {
+        static void format(const SmallList<T, N, A>& list, std::string_view fmt, Writer& writer) {
+            Formatter<Array<T>>::format(list, fmt, writer);
+        }
+    };
+
+    template<typename T, size_t N, typename A>
+    struct Owned<SmallList<T, N, A>> : public IOwned<SmallList<T, N, A>> {
+        // === Data ===
+        A& allocator;
+
+        // === Constructors / Assignments ===
+        Owned(A& allocator) noexcept : IOwned<SmallList<T, N, A>>(), allocator(allocator) {}
+        Owned(const Owned<SmallList<T, N, A>>&) noexcept = default;
+        Owned(Owned<SmallList<T, N, A>>&&) noexcept = default;
+
+        // === Destructor ===
+        ~Owned() {
+            this->destroy(allocator);
+        }
+
+        // === Associated Functions ===
+        SmallList<T, N, A> clone() const noexcept {
+            return this->as_ref().clone(allocator);
+        }
+
+        bool reserve(size_t min_capacity) noexcept {
+            return this->as_ref().reserve(allocator, min_capacity);
+        }
+
+        bool append(const T& item) noexcept {
+            return this->as_ref().append(allocator, item);
+        }
+
+        bool append(T&& item) noexcept {
+            return this->as_ref().append(allocator, std::move(item));
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args) noexcept {
+            return this->as_ref().emplace(allocator, std::forward<Args>(args)...);
+        }
+
+        bool extend(Array<T> items) noexcept {
+            return this->as_ref().extend(allocator, items);
+        }
+    };
+
+    template<typename T, size_t N, typename A = Allocator>
+    using OwnedSmallList = Owned<SmallList<T, N, A>>;
+
+    // Nothing in a SmallList points into itself, so it relocates exactly as well as its items do.
+    template<typename T, size_t N, typename A>
+    struct is_trivially_relocatable<SmallList<T, N, A>> : is_trivially_relocatable<T> {};
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <utility>
+
+#include "optional.h"
+#include "mem/allocator.h"
+#include "array.h"
+
+namespace sk {
+    // Bounded lock-free queue for exactly one producer thread and one consumer
+    // thread. Positions only ever increase and are masked into a power-of-two
+    // ring. The producer's and consumer's positions live on separate cache
+    // lines, and each side keeps a cached copy of the other's so it only reads
+    // the shared line when the queue looks full (or empty).
+    //
+    // `init` and `destroy` must not race with pushes or pops.
+    template<typename T, typename A = Allocator>
+    struct SpscQueue {
+        // === Data ===
+        // Written by the producer
+        alignas(64) std::atomic<size_t> _tail;
+        size_t _cached_head;
+
+        // Written by the consumer
+        alignas(64) std::atomic<size_t> _head;
+        size_t _cached_tail;
+
+        // Fixed after `init`
+        alignas(64) size_t capacity;
+        T* _items;
+
+        // === Constructors / Assignments ===
+        SpscQueue() noexcept : _tail(0), _cached_head(0), _head(0), _cached_tail(0), capacity(0), _items(nullptr) {}
+        SpscQueue(const SpscQueue<T, A>&) = delete;
+        SpscQueue(SpscQueue<T, A>&&) = delete;
+
+        SpscQueue<T, A>& operator=(const SpscQueue<T, A>&) = delete;
+        SpscQueue<T, A>& operator=(SpscQueue<T, A>&&) = delete;
+
+        // === Associated Functions ===
+
+        // Allocates room for at least `min_capacity` items, rounded up to a power of two.
+        bool init(A& ator, size_t min_capacity) noexcept {
+            auto capacity = size_t{ 1 };
+            while (capacity < min_capacity) {
+                capacity *= 2;
+            }
+
+            auto items = ator.template alloc<T>(capacity);
+            if (items.items == nullptr) {
+                return false;
+            }
+
+            this->capacity = capacity;
+            this->_items = items.items;
+            return true;
+        }
+
+        // Destroys whatever is still queued and frees the ring.
+        void destroy(A& ator) noexcept {
+            while (this->pop().is_some()) {}
+
+            if (this->_items != nullptr) {
+                ator.free(this->capacity, this->_items);
+            }
+
+            this->capacity = 0;
+            this->_items = nullptr;
+        }
+
+        // Only exact when neither side is running.
+        size_t size_approx() const noexcept {
+            return this->_tail.load(std::memory_order_relaxed) - this->_head.load(std::memory_order_relaxed);
+        }
+
+        // Producer only. How many of the next `wanted` slots are free.
+        size_t _free_slots(size_t tail, size_t wanted) noexcept {
+            auto free = this->capacity - (tail - this->_cached_head);
+            if (free < wanted) {
+                this->_cached_head = this->_head.load(std::memory_order_acquire);
+                free = this->capacity - (tail - this->_cached_head);
+            }
+            return free < wanted ? free : wanted;
+        }
+
+        // Consumer only. How many of the next `wanted` slots hold items.
+        size_t _filled_slots(size_t head, size_t wanted) noexcept {
+            auto filled = this->_cached_tail - head;
+            if (filled < wanted) {
+                this->_cached_tail = this->_tail.load(std::memory_order_acquire);
+                filled = this->_cached_tail - head;
+            }
+            return filled < wanted ? filled : wanted;
+        }
+
+        // Producer only. Returns false when the queue is full.
+        template<typename... Args>
+        bool emplace(Args&&... args) noexcept {
+            auto tail = this->_tail.load(std::memory_order_relaxed);
+            if (this->_free_slots(tail, 1) == 0) {
+                return false;
+            }
+
+            new (&this->_items[tail & (this->capacity - 1)]) T(std::forward<Args>(args)...);
+            this->_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool push(const T& item) noexcept {
+            return this->emplace(item);
+        }
+
+        bool push(T&& item) noexcept {
+            return this->emplace(std::move(item));
+        }
+
+        // Producer only. Copies as many of `items` as fit, publishing them all
+        // at once, and returns how many that was.
+        size_t push_n(Array<T> items) noexcept {
+            auto tail = this->_tail.load(std::memory_order_relaxed);
+            auto count = this->_free_slots(tail, items.len);
+
+            auto mask = this->capacity - 1;
+            for (size_t i = 0; i < count; i++) {
+                new (&this->_items[(tail + i) & mask]) T(items.items[i]);
+            }
+
+            this->_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // Consumer only. None when the queue is empty.
+        Optional<T> pop() noexcept {
+            auto head = this->_head.load(std::memory_order_relaxed);
+            if (this->_filled_slots(head, 1) == 0) {
+                return None;
+            }
+
+            auto& slot = this->_items[head & (this->capacity - 1)];
+            T item(std::move(slot));
+            slot.~T();
+
+            this->_head.store(head + 1, std::memory_order_release);
+            return item;
+        }
+
+        // Consumer only. Moves up to `out.len` items into `out`, whose items
+        // must already be constructed, and returns how many it moved.
+        size_t pop_n(Array<T> out) noexcept {
+            auto head = this->_head.load(std::memory_order_relaxed);
+            auto count = this->_filled_slots(head, out.len);
+
+            auto mask = this->capacity - 1;
+            for (size_t i = 0; i < count; i++) {
+                auto& slot = this->_items[(head + i) & mask];
+                out.items[i] = std::move(slot);
+                slot.~T();
+            }
+
+            this->_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+    };
+}
@@ -1,8 +1,11 @@
 #include "../string.h"
 
 #include "../fmt/writer.h"
+#include "../mem/c-allocator.h"
 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 namespace sk {
     String::String() noexcept :
@@ -107,6 +110,14 @@ namespace sk {
         return this->chars + this->len;
     }
 
+    bool operator==(const String& a, const String& b) noexcept {
+        return a.len == b.len && (a.len == 0 || memcmp(a.chars, b.chars, a.len) == 0);
+    }
+
+    bool operator!=(const String& a, const String& b) noexcept {
+        return !(a == b);
+    }
+
     std::ostream& operator<<(std::ostream& s, const String& str) noexcept {
         auto sv = str.view();
         return s << sv;
@@ -121,23 +132,26 @@ namespace sk {
     }
 
     StringBuilder::StringBuilder(size_t capacity) noexcept :
-        max_capacity(-1),
-        capacity(capacity),
-        len(0),
-        chars(new char[capacity])
+        StringBuilder(capacity, -1)
     {
     }
 
     StringBuilder::StringBuilder(size_t capacity, size_t max_capacity) noexcept :
+        capacity(0),
         max_capacity(max_capacity),
-        capacity(capacity),
         len(0),
-        chars(new char[capacity])
+        chars(reinterpret_cast<char*>(malloc(capacity)))
     {
+        // `chars` is grown with realloc so it has to come from malloc, which
+        // also tells us how much room we really got.
+        if (this->chars) {
+            auto usable = internal::malloc_usable_size(this->chars, capacity);
+            this->capacity = usable > max_capacity ? max_capacity : usable;
+        }
     }
 
     StringBuilder& StringBuilder::append(String s) noexcept {
-        if (this->capacity >= s.len) {
+        if (this->capacity - this->len >= s.len) {
             memcpy(&this->chars[this->len], s.chars, s.len);
             this->len += s.len;
         } else {
@@ -148,6 +162,11 @@ namespace sk {
             auto new_chars = reinterpret_cast<char*>(realloc(this->chars, new_capacity));
             assert(new_chars);
 
+            auto usable = internal::malloc_usable_size(new_chars, new_capacity);
+            if (usable > new_capacity) {
+                new_capacity = usable > this->max_capacity ? this->max_capacity : usable;
+            }
+
             auto num_chars_to_write = s.len;
             if (this->len + num_chars_to_write > new_capacity) {
                 num_chars_to_write = new_capacity - this->len;
@@ -54,6 +54,8 @@ namespace sk {
         const char* end() const noexcept;
 
         // === Friends ===
+        friend bool operator==(const String& a, const String& b) noexcept;
+        friend bool operator!=(const String& a, const String& b) noexcept;
         friend std::ostream& operator<<(std::ostream& s, const String& str) noexcept;
     };
 
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "mem/allocator.h"
+#include "mem/relocate.h"
+#include "hash.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sk {
+    namespace internal {
+        // Every slot has a control byte: a 7-bit fragment of its key's hash
+        // when full, or one of these negative markers.
+        inline constexpr int8_t ctrl_empty = -128;
+        inline constexpr int8_t ctrl_deleted = -2;
+        inline constexpr size_t group_width = 16;
+
+        // Sixteen control bytes examined at once. Each query returns a bit
+        // mask with bit `i` set when slot `i` of the group matches.
+        struct ControlGroup {
+#if defined(__SSE2__)
+            __m128i ctrl;
+
+            explicit ControlGroup(const int8_t* group) noexcept :
+                ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(group)))
+            {
+            }
+
+            uint32_t match(int8_t h2) const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl)));
+            }
+
+            uint32_t match_empty() const noexcept {
+                return this->match(ctrl_empty);
+            }
+
+            uint32_t match_empty_or_deleted() const noexcept {
+                // Both markers are below -1, full slots are not
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), this->ctrl)));
+            }
+#else
+            const int8_t* ctrl;
+
+            explicit ControlGroup(const int8_t* group) noexcept : ctrl(group) {}
+
+            uint32_t match(int8_t h2) const noexcept {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < group_width; i++) {
+                    mask |= static_cast<uint32_t>(this->ctrl[i] == h2) << i;
+                }
+                return mask;
+            }
+
+            uint32_t match_empty() const noexcept {
+                return this->match(ctrl_empty);
+            }
+
+            uint32_t match_empty_or_deleted() const noexcept {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < group_width; i++) {
+                    mask |= static_cast<uint32_t>(this->ctrl[i] < -1) << i;
+                }
+                return mask;
+            }
+#endif
+        };
+
+        inline size_t next_power_of_two(size_t n) noexcept {
+            return n <= 1 ? 1 : size_t{ 1 } << (64 - __builtin_clzll(n - 1));
+        }
+
+        // The open-addressing table behind HashMap and HashSet, in the style of
+        // Swiss tables. Slots are split into groups of 16 whose control bytes
+        // are probed with one SIMD compare, so most lookups touch one group of
+        // control bytes and one slot. Slots of type `S` live in a single
+        // allocation next to their control bytes; `KeyOf::get(slot)` gives the
+        // key a slot is stored under. The table grows at 7/8 load.
+        //
+        // Erasing only leaves a tombstone when the slot's group is completely
+        // full; otherwise no probe sequence can pass through the group and the
+        // slot simply becomes empty again.
+        template<typename S, typename K, typename A, typename H, typename KeyOf>
+        struct SwissTable {
+            // === Structures ===
+            struct Iterator {
+                const SwissTable<S, K, A, H, KeyOf>* table;
+                size_t index;
+
+                S& operator*() const noexcept {
+                    return this->table->_slots[this->index];
+                }
+
+                S* operator->() const noexcept {
+                    return &this->table->_slots[this->index];
+                }
+
+                Iterator& operator++() noexcept {
+                    this->index = this->table->_next_full(this->index + 1);
+                    return *this;
+                }
+
+                bool operator!=(const Iterator& other) const noexcept {
+                    return this->index != other.index;
+                }
+            };
+
+            // === Data ===
+            size_t capacity; // 0 or a power of two of at least 16
+            size_t len;
+            size_t _growth_left;
+            int8_t* _ctrl;
+            S* _slots;
+            size_t _alloc_len; // bytes the allocator returned, freed with the same length
+
+            // === Constructors / Assignments ===
+            SwissTable() noexcept : capacity(0), len(0), _growth_left(0), _ctrl(nullptr), _slots(nullptr), _alloc_len(0) {}
+
+            // === Layout ===
+            static size_t _max_load(size_t capacity) noexcept {
+                return capacity - capacity / 8;
+            }
+
+            static size_t _slots_offset(size_t capacity) noexcept {
+                return align_forward(capacity, alignof(S));
+            }
+
+            static size_t _allocation_size(size_t capacity) noexcept {
+                return SwissTable::_slots_offset(capacity) + capacity * sizeof(S);
+            }
+
+            static uint32_t _allocation_align() noexcept {
+                return static_cast<uint32_t>(alignof(S) > group_width ? alignof(S) : group_width);
+            }
+
+            static int8_t _h2(uint64_t hash) noexcept {
+                return static_cast<int8_t>(hash & 0x7f);
+            }
+
+            // === Associated Functions ===
+            size_t size() const noexcept {
+                return this->len;
+            }
+
+            bool _is_full(size_t index) const noexcept {
+                return this->_ctrl[index] >= 0;
+            }
+
+            size_t _next_full(size_t index) const noexcept {
+                while (index < this->capacity && !this->_is_full(index)) {
+                    index++;
+                }
+                return index;
+            }
+
+            // Calls `f(first_slot)` for each group on the probe sequence of `hash`
+            // until it returns true. Triangular steps over a power-of-two group
+            // count visit every group.
+            template<typename F>
+            void _probe(uint64_t hash, F&& f) const noexcept {
+                auto mask = this->capacity / group_width - 1;
+                auto group = static_cast<size_t>(hash >> 7) & mask;
+                for (size_t step = 1; !f(group * group_width); step++) {
+                    group = (group + step) & mask;
+                }
+            }
+
+            size_t _find(const K& key, uint64_t hash) const noexcept {
+                if (this->capacity == 0) {
+                    return SIZE_MAX;
+                }
+
+                auto h2 = SwissTable::_h2(hash);
+                size_t found = SIZE_MAX;
+                this->_probe(hash, [&](size_t first) {
+                    auto group = ControlGroup(&this->_ctrl[first]);
+                    for (auto bits = group.match(h2); bits != 0; bits &= bits - 1) {
+                        auto index = first + __builtin_ctz(bits);
+                        if (KeyOf::get(this->_slots[index]) == key) {
+                            found = index;
+                            return true;
+                        }
+                    }
+                    return group.match_empty() != 0;
+                });
+
+                return found;
+            }
+
+            size_t _find_insert_slot(uint64_t hash) const noexcept {
+                size_t slot = 0;
+                this->_probe(hash, [&](size_t first) {
+                    auto bits = ControlGroup(&this->_ctrl[first]).match_empty_or_deleted();
+                    if (bits == 0) {
+                        return false;
+                    }
+                    slot = first + __builtin_ctz(bits);
+                    return true;
+                });
+                return slot;
+            }
+
+            // Moves every slot into a fresh table of at least `min_capacity`
+            // slots, which also clears out tombstones.
+            bool rehash(A& ator, size_t min_capacity) noexcept {
+                auto needed = min_capacity > this->len ? min_capacity : this->len;
+                auto new_capacity = next_power_of_two(needed);
+                if (new_capacity < group_width) {
+                    new_capacity = group_width;
+                }
+                if (SwissTable::_max_load(new_capacity) < this->len) {
+                    new_capacity *= 2;
+                }
+
+                auto memory = ator.template alloc<uint8_t>(SwissTable::_allocation_size(new_capacity), SwissTable::_allocation_align());
+                if (memory.items == nullptr) {
+                    return false;
+                }
+
+                auto old = *this;
+                this->capacity = new_capacity;
+                this->_ctrl = reinterpret_cast<int8_t*>(memory.items);
+                this->_slots = reinterpret_cast<S*>(memory.items + SwissTable::_slots_offset(new_capacity));
+                this->_alloc_len = memory.len;
+                memset(this->_ctrl, static_cast<uint8_t>(ctrl_empty), new_capacity);
+
+                for (size_t i = 0; i < old.capacity; i++) {
+                    if (!old._is_full(i)) {
+                        continue;
+                    }
+
+                    auto hash = H{}(KeyOf::get(old._slots[i]));
+                    auto slot = this->_find_insert_slot(hash);
+                    this->_ctrl[slot] = SwissTable::_h2(hash);
+                    relocate(&this->_slots[slot], &old._slots[i], 1);
+                }
+
+                this->_growth_left = SwissTable::_max_load(new_capacity) - this->len;
+
+                if (old._ctrl != nullptr) {
+                    ator.free(old._alloc_len, reinterpret_cast<uint8_t*>(old._ctrl), SwissTable::_allocation_align());
+                }
+
+                return true;
+            }
+
+            // Makes room for `count` entries in total without further rehashing.
+            bool reserve(A& ator, size_t count) noexcept {
+                if (count <= this->len + this->_growth_left) {
+                    return true;
+                }
+
+                return this->rehash(ator, next_power_of_two(count + count / 7 + 1));
+            }
+
+            bool _make_room(A& ator) noexcept {
+                if (this->capacity == 0) {
+                    return this->rehash(ator, group_width);
+                }
+
+                // Mostly tombstones: rebuilding at the same size is enough
+                if (this->len <= SwissTable::_max_load(this->capacity) / 2) {
+                    return this->rehash(ator, this->capacity);
+                }
+
+                return this->rehash(ator, this->capacity * 2);
+            }
+
+            bool contains(const K& key) const noexcept {
+                return this->_find(key, H{}(key)) != SIZE_MAX;
+            }
+
+            // Returns the slot holding `key`, or claims a free one for it and
+            // leaves the caller to construct the slot in place. `*found` says
+            // which. SIZE_MAX when the table could not grow.
+            size_t _find_or_claim(A& ator, const K& key, uint64_t hash, bool* found) noexcept {
+                auto index = this->_find(key, hash);
+                if (index != SIZE_MAX) {
+                    *found = true;
+                    return index;
+                }
+
+                auto slot = this->capacity > 0 ? this->_find_insert_slot(hash) : 0;
+                if (this->capacity == 0 || (this->_growth_left == 0 && this->_ctrl[slot] == ctrl_empty)) {
+                    if (!this->_make_room(ator)) {
+                        return SIZE_MAX;
+                    }
+                    slot = this->_find_insert_slot(hash);
+                }
+
+                // Reusing a tombstone does not use up any of the load budget
+                if (this->_ctrl[slot] == ctrl_empty) {
+                    this->_growth_left--;
+                }
+
+                this->_ctrl[slot] = SwissTable::_h2(hash);
+                this->len++;
+
+                *found = false;
+                return slot;
+            }
+
+            bool remove(const K& key) noexcept {
+                auto index = this->_find(key, H{}(key));
+                if (index == SIZE_MAX) {
+                    return false;
+                }
+
+                this->_slots[index].~S();
+                this->len--;
+
+                auto first = index & ~(group_width - 1);
+                if (ControlGroup(&this->_ctrl[first]).match_empty() != 0) {
+                    this->_ctrl[index] = ctrl_empty;
+                    this->_growth_left++;
+                } else {
+                    this->_ctrl[index] = ctrl_deleted;
+                }
+
+                return true;
+            }
+
+            // Removes every entry but keeps the table.
+            void clear() noexcept {
+                if constexpr (!std::is_trivially_destructible_v<S>) {
+                    for (size_t i = 0; i < this->capacity; i++) {
+                        if (this->_is_full(i)) {
+                            this->_slots[i].~S();
+                        }
+                    }
+                }
+
+                if (this->capacity > 0) {
+                    memset(this->_ctrl, static_cast<uint8_t>(ctrl_empty), this->capacity);
+                }
+
+                this->len = 0;
+                this->_growth_left = SwissTable::_max_load(this->capacity);
+            }
+
+            void destroy(A& ator) noexcept {
+                this->clear();
+                if (this->_ctrl != nullptr) {
+                    ator.free(this->_alloc_len, reinterpret_cast<uint8_t*>(this->_ctrl), SwissTable::_allocation_align());
+                }
+
+                *this = SwissTable<S, K, A, H, KeyOf>{};
+            }
+
+            // === Iterator Stuff ===
+            Iterator begin() const noexcept {
+                return { this, this->_next_full(0) };
+            }
+
+            Iterator end() const noexcept {
+                return { this, this->capacity };
+            }
+        };
+    }
+}
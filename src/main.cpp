@@ -5,12 +5,34 @@
 #include "sk/array.h"
 #include "sk/defer.h"
 #include "sk/list.h"
+#include "sk/small-list.h"
+#include "sk/hash-map.h"
+#include "sk/hash-set.h"
+#include "sk/flat-set.h"
+#include "sk/deque.h"
+#include "sk/spsc-queue.h"
+#include "sk/mpmc-queue.h"
+#include "sk/segmented-list.h"
+#include "sk/slot-map.h"
 #include "sk/mem/c-allocator.h"
 #include "sk/mem/arena-allocator.h"
+#include "sk/mem/virtual-arena-allocator.h"
+#include "sk/mem/pool-allocator.h"
+#include "sk/mem/size-class-allocator.h"
+#include "sk/mem/concurrent-arena-allocator.h"
+#include "sk/mem/scratch.h"
+#include "sk/mem/tracking-allocator.h"
+#include "sk/mem/profiling-allocator.h"
+#include "sk/mem/buddy-allocator.h"
+#include "sk/mem/tlsf-allocator.h"
+#include "sk/mem/huge-page-allocator.h"
+#include "sk/mem/persistent-arena-allocator.h"
 #include "sk/ptr/nonnull.h"
 #include "sk/ptr/owned.h"
 #include "sk/gfx/canvas.h"
 
+#include <thread>
+
 #define FILE __FILE__
 #define LINE __LINE__
 
@@ -247,6 +269,667 @@ void arena_allocator_example() {
 
         sk::println("{} at {}", ints, ints.items);
     }
+
+    {
+        auto arena = sk::ArenaAllocator{ &sk::c_allocator, 256 };
+        defer { arena.destroy(); };
+
+        auto cs = arena.alloc<char>(12);
+        auto fs = arena.alloc<float>(3);
+        auto line = arena.alloc<uint64_t>(8, 64);
+
+        sk::println("cs   at {}", cs.items);
+        sk::println("fs   at {} (4-byte aligned: {})", fs.items, reinterpret_cast<uintptr_t>(fs.items) % alignof(float) == 0);
+        sk::println("line at {} (64-byte aligned: {})", line.items, reinterpret_cast<uintptr_t>(line.items) % 64 == 0);
+    }
+}
+
+void arena_reset_example() {
+    auto policy = sk::ArenaGrowthPolicy{};
+    policy.growth_factor = 2;
+    policy.max_block_size = 1024;
+    policy.max_retained = 4096;
+
+    auto arena = sk::ArenaAllocator{ &sk::c_allocator, 64, policy };
+    defer { arena.destroy(); };
+
+    for (int request = 0; request < 3; request++) {
+        for (int i = 0; i < 16; i++) {
+            arena.alloc<int>(i + 1);
+        }
+
+        size_t blocks = 0;
+        for (auto it = arena._blocks; it; it = it->next) blocks++;
+
+        arena.reset();
+
+        size_t free_blocks = 0;
+        for (auto it = arena._free_blocks; it; it = it->next) free_blocks++;
+
+        sk::println("request {}: used {} blocks, {} recycled ({} bytes retained)", request, blocks, free_blocks, arena._retained);
+    }
+}
+
+void virtual_arena_example() {
+    auto arena = sk::VirtualArenaAllocator::make(1ull << 32).expect("Failed to reserve address space.");
+    defer { arena.destroy(); };
+
+    sk::List<int> list;
+    list.append(arena, 0);
+    auto first_address = list.items;
+
+    for (int i = 1; i < 100000; i++) {
+        list.append(arena, i);
+    }
+
+    sk::println("reserved  = {}", arena.reserved);
+    sk::println("committed = {}", arena.committed());
+    sk::println("list grew in place: {}", list.items == first_address);
+
+    arena.reset();
+    sk::println("committed after reset = {}", arena.committed());
+}
+
+void pool_allocator_example() {
+    struct Node {
+        Node* next;
+        int value;
+    };
+
+    auto pool = sk::PoolAllocator::make<Node>(&sk::c_allocator, 4096);
+    defer { pool.destroy(); };
+
+    Node* head = nullptr;
+    for (int i = 0; i < 1000; i++) {
+        auto node = pool.create<Node>();
+        node->next = head;
+        node->value = i;
+        head = node;
+    }
+
+    size_t partial = 0, full = 0;
+    for (auto it = pool._partial; it; it = it->next) partial++;
+    for (auto it = pool._full; it; it = it->next) full++;
+    sk::println("slot_size = {}, slots_per_slab = {}", pool.slot_size, pool.slots_per_slab);
+    sk::println("slabs: {} full, {} partial", full, partial);
+
+    int total = 0;
+    while (head) {
+        auto next = head->next;
+        total += head->value;
+        pool.destroy(head);
+        head = next;
+    }
+
+    sk::println("total = {}, all slabs released: {}", total, pool._partial == nullptr && pool._full == nullptr);
+}
+
+void size_class_allocator_example() {
+    auto list = sk::OwnedList<int>{ sk::size_class_allocator };
+    for (int i = 0; i < 100; i++) {
+        list.append(i);
+    }
+
+    sk::println("list.capacity = {}", list.capacity);
+
+    // Thread caches only report to the central heap in batches.
+    sk::SizeClassAllocator::flush_thread_cache();
+
+    for (size_t i = 0; i < sk::SizeClassAllocator::class_count; i++) {
+        auto stats = sk::SizeClassAllocator::stats(i);
+        if (stats.allocs > 0) {
+            sk::println("{}", stats);
+        }
+    }
+}
+
+void concurrent_arena_example() {
+    auto arena = sk::ConcurrentArenaAllocator{ &sk::c_allocator, 4096 };
+    defer { arena.destroy(); };
+
+    constexpr int per_thread = 1000;
+    sk::Array<int> results[4];
+
+    std::thread workers[4];
+    for (int t = 0; t < 4; t++) {
+        workers[t] = std::thread([&, t]() {
+            results[t] = arena.alloc<int>(per_thread);
+            for (int i = 0; i < per_thread; i++) {
+                results[t][i] = t + 1;
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int t = 0; t < 4; t++) {
+        sk::println("worker {}: {} ints at {}, sum = {}", t, results[t].len, results[t].items, sum_array(results[t]));
+    }
+}
+
+sk::List<int> squares_of_evens(sk::Allocator& ator, sk::Array<int> ns) {
+    // Temporary list, rewound when `tmp` goes out of scope
+    auto tmp = sk::scratch(&ator);
+
+    sk::List<int> evens;
+    for (int n : ns) {
+        if (n % 2 == 0) {
+            evens.append(tmp, n);
+        }
+    }
+
+    sk::List<int> result;
+    for (int n : evens) {
+        result.append(ator, n * n);
+    }
+
+    return result;
+}
+
+void scratch_example() {
+    int ns[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    auto outer = sk::scratch();
+    auto mark = outer.arena.mark();
+
+    // The result lives in the caller's scratch arena, so the callee must
+    // pick the other one for its temporaries.
+    auto squares = squares_of_evens(outer, sk::Array{ 8, ns });
+    sk::println("squares = {}", squares);
+    sk::println("outer arena moved: {}", outer.arena.mark()._index != mark._index);
+
+    auto inner = sk::scratch(&outer.arena);
+    sk::println("inner uses a different arena: {}", &inner.arena != &outer.arena);
+}
+
+void static_allocator_list_example() {
+    auto arena = sk::ArenaAllocator{ &sk::c_allocator, 1024 };
+    defer { arena.destroy(); };
+
+    // Calls into `arena` are resolved at compile time
+    auto list = sk::OwnedList<int, sk::ArenaAllocator>{ arena };
+    for (int i = 0; i < 10; i++) {
+        list.append(i * i);
+    }
+
+    sk::println("list = {}", list);
+}
+
+void tracking_allocator_example() {
+    auto tracking = sk::TrackingAllocator{ &sk::c_allocator, true, true };
+
+    {
+        // Every block the arena asks for shows up in the size histogram
+        auto arena = sk::ArenaAllocator{ &tracking, 256, { 2, 4096 } };
+        defer { arena.destroy(); };
+
+        for (int i = 0; i < 64; i++) {
+            arena.alloc<uint64_t>(i);
+        }
+
+        auto list = sk::OwnedList<int>{ tracking };
+        for (int i = 0; i < 1000; i++) {
+            list.append(i);
+        }
+
+        sk::println("{:#}", tracking.stats());
+    }
+
+    sk::println("{}", tracking.stats());
+}
+
+void allocation_balance_example() {
+    // Every container gives back exactly what it took once it is torn down
+    auto tracking = sk::TrackingAllocator{ &sk::c_allocator, false };
+
+    {
+        auto list = sk::OwnedList<int>{ tracking };
+        for (int i = 0; i < 1000; i++) {
+            list.append(i);
+        }
+
+        auto small = sk::OwnedSmallList<int, 8>{ tracking };
+        for (int i = 0; i < 100; i++) {
+            small.append(i);
+        }
+
+        auto map = sk::OwnedHashMap<int, int>{ tracking };
+        for (int i = 0; i < 1000; i++) {
+            map.insert(i, i * i);
+        }
+
+        auto ids = sk::OwnedHashSet<uint64_t>{ tracking };
+        for (uint64_t i = 0; i < 1000; i++) {
+            ids.insert(i % 700);
+        }
+
+        std::string words[] = { "pear", "fig", "apple", "fig", "kiwi" };
+        auto set = sk::OwnedFlatSet<std::string>{ tracking };
+        set.insert_many(sk::Array<std::string>{ 5, words });
+
+        auto deque = sk::OwnedDeque<int>{ tracking };
+        for (int i = 0; i < 1000; i++) {
+            deque.push_back(i);
+        }
+
+        auto segments = sk::OwnedSegmentedList<int>{ tracking };
+        for (int i = 0; i < 1000; i++) {
+            segments.append(i);
+        }
+
+        auto slots = sk::OwnedSlotMap<int>{ tracking };
+        auto handle = slots.insert(7).unwrap();
+        slots.insert(8);
+        slots.remove(handle);
+
+        auto canvas = sk::Canvas::make(tracking, 33, 7);
+        canvas.destroy(tracking);
+    }
+
+    auto stats = tracking.stats();
+    assert(stats.live_bytes == 0 && stats.allocs == stats.frees);
+    sk::println("allocs: {}, frees: {}, live_bytes after teardown: {}", stats.allocs, stats.frees, stats.live_bytes);
+}
+
+void build_big_list(sk::Allocator& ator) {
+    auto list = sk::OwnedList<uint64_t>{ ator };
+    for (uint64_t i = 0; i < 100000; i++) {
+        list.append(i);
+    }
+}
+
+void build_many_small_lists(sk::Allocator& ator) {
+    for (int l = 0; l < 2000; l++) {
+        auto list = sk::OwnedList<uint32_t>{ ator };
+        for (uint32_t i = 0; i < 32; i++) {
+            list.append(i);
+        }
+    }
+}
+
+void profiling_allocator_example() {
+    auto profiler = sk::ProfilingAllocator{ &sk::c_allocator, 4096 };
+
+    build_big_list(profiler);
+    build_many_small_lists(profiler);
+
+    sk::println("sampled ~{} bytes", profiler.sampled_bytes());
+
+    // Pipe into flamegraph.pl to get a picture of where memory comes from
+    profiler.write_folded(sk::out);
+}
+
+void buddy_allocator_example() {
+    auto buddy = sk::BuddyAllocator::make(&sk::c_allocator, 4 * 1024 * 1024).expect("Failed to reserve buddy region.");
+    defer { buddy.destroy(); };
+
+    sk::println("{}", buddy.stats());
+
+    // A bounded heap for canvases with irregular lifetimes
+    auto a = sk::Canvas::make(buddy, 256, 256);
+    auto b = sk::Canvas::make(buddy, 512, 512);
+    auto c = sk::Canvas::make(buddy, 128, 128);
+    sk::println("{}", buddy.stats());
+
+    a.destroy(buddy);
+    sk::println("{}", buddy.stats());
+
+    b.destroy(buddy);
+    c.destroy(buddy);
+    sk::println("{}", buddy.stats());
+
+    // With its buddy free, a block can double without moving
+    auto pixels = buddy.alloc<sk::Pixel>(16 * 1024);
+    auto grown = buddy.resize(pixels, 32 * 1024).unwrap();
+    sk::println("grew in place: {}", grown.items == pixels.items);
+    buddy.free(grown);
+}
+
+void tlsf_allocator_example() {
+    // A fixed pool with bounded-time operations, e.g. for an audio or render thread
+    alignas(16) static uint8_t memory[256 * 1024];
+    auto tlsf = sk::TLSFAllocator::make(sk::Array<uint8_t>{ sizeof(memory), memory }).expect("Pool too small.");
+    defer { tlsf.destroy(); };
+
+    auto initial = tlsf.free_bytes();
+    sk::println("free bytes: {}", initial);
+
+    sk::List<int> numbers;
+    for (int i = 0; i < 1000; i++) {
+        numbers.append(tlsf, i);
+    }
+    sk::println("numbers[999] = {}", numbers[999]);
+
+    auto page = tlsf.alloc<uint8_t>(100, 4096);
+    sk::println("4096-aligned: {}", reinterpret_cast<uintptr_t>(page.items) % 4096 == 0);
+
+    tlsf.free(page, 4096);
+    numbers.destroy(tlsf);
+    sk::println("free bytes after release: {} (all coalesced: {})", tlsf.free_bytes(), tlsf.free_bytes() == initial);
+}
+
+void huge_page_allocator_example() {
+    sk::HugePageAllocator huge(&sk::c_allocator);
+
+    // A 4K framebuffer gets its own huge page mapping...
+    auto frame = sk::Canvas::make(huge, 3840, 2160);
+    defer { frame.destroy(huge); };
+    for (auto& pixel : frame.pixels) {
+        pixel = 0xFF202020;
+    }
+
+    // ...while small canvases still come from the fallback allocator
+    auto icon = sk::Canvas::make(huge, 32, 32);
+    defer { icon.destroy(huge); };
+
+    auto info = huge.query(frame.pixels.items);
+    if (info.is_some()) {
+        auto frame_info = info.unwrap();
+        sk::println("frame: {} of {} bytes on huge pages", frame_info.huge_bytes, frame_info.mapped_size);
+    }
+    sk::println("icon on huge pages: {}", huge.query(icon.pixels.items).is_some());
+
+    huge.write_report(sk::out);
+}
+
+void persistent_arena_example() {
+    const char* path = "/tmp/sklib-example.arena";
+    ::remove(path);
+
+    {
+        auto arena = sk::PersistentArenaAllocator::open(path, 64 * 1024 * 1024).expect("Failed to open arena file.");
+        sk::println("created: {}", arena.created);
+
+        auto squares = arena.create<sk::List<uint64_t>>();
+        for (uint64_t i = 0; i < 100000; i++) {
+            squares->append(arena, i * i);
+        }
+
+        arena.set_root(squares);
+        arena.flush();
+        arena.close();
+    }
+
+    // Normally a later run of the program: the table is usable straight away
+    auto arena = sk::PersistentArenaAllocator::open(path, 64 * 1024 * 1024).expect("Failed to reopen arena file.");
+    defer {
+        arena.close();
+        ::remove(path);
+    };
+
+    auto squares = arena.root<sk::List<uint64_t>>();
+    sk::println("created: {}, entries: {}, squares[300] = {}", arena.created, squares->len, (*squares)[300]);
+}
+
+struct GraphNode {
+    int id;
+    sk::List<GraphNode*> edges;
+};
+
+void batch_allocation_example() {
+    sk::ArenaAllocator arena(&sk::c_allocator, 64 * 1024);
+    defer { arena.destroy(); };
+
+    // All nodes come from one batch request instead of one call per node
+    sk::List<GraphNode*> nodes;
+    nodes.append_nodes(arena, 8);
+    for (size_t i = 0; i < nodes.len; i++) {
+        nodes[i]->id = static_cast<int>(i);
+        nodes[i]->edges.append(arena, nodes[(i + 1) % nodes.len]);
+    }
+    sk::println("node 7 -> node {}", nodes[7]->edges[0]->id);
+
+    // The same works on any allocator; frees are batched as well
+    sk::List<GraphNode*> heap_nodes;
+    heap_nodes.append_nodes(sk::c_allocator, 1000);
+    sk::println("heap nodes: {}", heap_nodes.len);
+    heap_nodes.destroy_nodes(sk::c_allocator);
+    heap_nodes.destroy(sk::c_allocator);
+}
+
+void move_aware_list_example() {
+    // std::string keeps short strings inside itself, so it must be moved
+    // element by element rather than memcpy'd when the list grows
+    sk::List<std::string> names;
+    defer { names.destroy(sk::c_allocator); };
+
+    names.emplace(sk::c_allocator, "ada");
+    names.emplace(sk::c_allocator, 3, 'z');
+
+    std::string long_name = "a name long enough to live on the heap";
+    names.append(sk::c_allocator, std::move(long_name));
+    for (int i = 0; i < 5; i++) {
+        names.append(sk::c_allocator, names[0]);
+    }
+
+    auto copy = names.clone(sk::c_allocator);
+    defer { copy.destroy(sk::c_allocator); };
+    copy[0] += "!";
+
+    sk::println("names[1] = {}, names[2] = {}, len = {}", names[1].c_str(), names[2].c_str(), names.len);
+    sk::println("copy[0] = {}, names[0] = {}", copy[0].c_str(), names[0].c_str());
+    sk::println("std::string trivially relocatable: {}, sk::String: {}",
+        sk::is_trivially_relocatable_v<std::string>, sk::is_trivially_relocatable_v<sk::String>);
+}
+
+void bulk_list_example() {
+    auto list = sk::OwnedList<int>{ sk::c_allocator };
+
+    int chunk[] = { 1, 2, 3, 4, 5 };
+    list.reserve(32);
+    list.extend(sk::Array{ 5, chunk });
+    list.append_n(3, 0);
+    sk::println("extend + append_n:  {}", list);
+
+    int middle[] = { 10, 20 };
+    list.insert(sk::Array{ 2, middle }, 2);
+    sk::println("insert at 2:        {}", list);
+
+    list.remove_range(0, 2);
+    sk::println("remove_range(0, 2): {}", list);
+
+    auto removed = list.swap_remove(0);
+    sk::println("swap_remove(0) = {}: {}", removed, list);
+
+    list.resize(10);
+    sk::println("resize(10):         {}", list);
+
+    // Extending from itself is fine even when it reallocates
+    list.extend(list.as_ref());
+    sk::println("self-extend len = {}", list.len);
+}
+
+void small_list_example() {
+    sk::TrackingAllocator tracking(&sk::c_allocator);
+
+    // Up to four items live inside the list itself
+    sk::SmallList<int, 4> small;
+    for (int i = 1; i <= 4; i++) {
+        small.append(tracking, i * 10);
+    }
+    sk::println("{} inline: {}, allocations: {}", small, small.is_inline(), tracking.stats().allocs);
+
+    // The fifth spills to the allocator
+    small.append(tracking, 50);
+    sk::println("{} inline: {}, allocations: {}", small, small.is_inline(), tracking.stats().allocs);
+    small.destroy(tracking);
+
+    auto owned = sk::OwnedSmallList<const char*, 2>{ sk::c_allocator };
+    owned.append("inline");
+    owned.append("too");
+    sk::Array<const char*> view = owned;
+    sk::println("{:#}", view);
+}
+
+void hash_map_example() {
+    sk::HashMap<sk::String, int> counts;
+    const char* words[] = { "the", "cat", "sat", "on", "the", "mat", "the", "end" };
+    for (auto word : words) {
+        counts.get_or_insert(sk::c_allocator, word).unwrap() += 1;
+    }
+    sk::println("{} distinct words, \"the\" x{}", counts.len, counts.get("the").unwrap());
+
+    counts.remove("cat");
+    sk::println("has cat: {}, has mat: {}", counts.contains("cat"), counts.contains("mat"));
+    counts.destroy(sk::c_allocator);
+
+    auto squares = sk::OwnedHashMap<int, int>{ sk::c_allocator };
+    for (int i = 0; i < 1000; i++) {
+        squares.insert(i, i * i);
+    }
+    sk::println("{} entries in {} slots, 999^2 = {}", squares.len, squares.capacity, squares.get(999).unwrap());
+}
+
+void hash_set_example() {
+    uint64_t ids[] = { 42, 7, 42, 13, 7, 99, 42 };
+
+    auto seen = sk::OwnedHashSet<uint64_t>{ sk::c_allocator };
+    for (auto id : ids) {
+        bool inserted;
+        seen.insert(id, &inserted);
+        if (!inserted) {
+            sk::println("duplicate id {}", id);
+        }
+    }
+    sk::println("{} unique ids, has 13: {}", seen.len, seen.contains(13));
+}
+
+void flat_set_example() {
+    int batch1[] = { 9, 3, 7, 3, 1 };
+    int batch2[] = { 8, 2, 9, 4 };
+
+    auto set = sk::OwnedFlatSet<int>{ sk::c_allocator };
+    set.insert_many(sk::Array<int>{ 5, batch1 });
+    set.insert_many(sk::Array<int>{ 4, batch2 });
+    set.insert(5);
+    set.remove(1);
+    sk::println("{} contains 7: {}, lower_bound(6) = {}", set, set.contains(7), set.lower_bound(6));
+}
+
+void deque_example() {
+    auto jobs = sk::OwnedDeque<int>{ sk::c_allocator };
+    for (int i = 1; i <= 6; i++) {
+        jobs.push_back(i);
+    }
+    jobs.push_front(0);
+    sk::println("{} front: {}, back: {}", jobs, jobs.front().unwrap(), jobs.back().unwrap());
+
+    // Popping a few and pushing more makes the items wrap around the buffer
+    sk::println("popped {}", jobs.pop_front_n(4));
+    int more[] = { 7, 8, 9, 10, 11 };
+    jobs.push_back(sk::Array<int>{ 5, more });
+    sk::println("{} capacity: {}, {}", jobs, jobs.capacity, jobs.as_slices());
+}
+
+void lock_free_queue_example() {
+    // One stage hands numbers to the next through a bounded ring
+    sk::SpscQueue<int> stage;
+    stage.init(sk::c_allocator, 16);
+
+    std::thread producer([&] {
+        int batch[4] = {};
+        for (int i = 1; i <= 100; i += 4) {
+            for (int k = 0; k < 4; k++) {
+                batch[k] = i + k;
+            }
+
+            size_t pushed = 0;
+            while (pushed < 4) {
+                pushed += stage.push_n(sk::Array<int>{ 4 - pushed, batch + pushed });
+            }
+        }
+    });
+
+    int sum = 0;
+    for (int received = 0; received < 100; ) {
+        auto item = stage.pop();
+        if (item.is_some()) {
+            sum += item.unwrap();
+            received++;
+        }
+    }
+    producer.join();
+    stage.destroy(sk::c_allocator);
+    sk::println("spsc: sum of 1..100 = {}", sum);
+
+    // Any number of threads on either side
+    sk::MpmcQueue<int> work;
+    work.init(sk::c_allocator, 64);
+
+    std::atomic<int> total = 0;
+    std::thread workers[3];
+    for (int w = 0; w < 3; w++) {
+        workers[w] = std::thread([&, w] {
+            for (int i = 0; i < 10; i++) {
+                while (!work.push(w * 10 + i)) {}
+            }
+            for (int popped = 0; popped < 10; ) {
+                auto item = work.pop();
+                if (item.is_some()) {
+                    total += item.unwrap();
+                    popped++;
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    work.destroy(sk::c_allocator);
+    sk::println("mpmc: sum of 0..29 = {}", total.load());
+}
+
+void segmented_list_example() {
+    struct Particle {
+        float x, y;
+    };
+
+    auto particles = sk::OwnedSegmentedList<Particle>{ sk::c_allocator };
+    particles.append(Particle{ 1.0f, 2.0f });
+
+    // Safe to hold on to: growing never moves existing items
+    auto first = sk::NonNull<Particle>::make(&particles[0]).unwrap();
+    for (int i = 1; i < 100; i++) {
+        particles.append(Particle{ static_cast<float>(i), 0.0f });
+    }
+    sk::println("first still at ({:.1}, {:.1}) after {} appends", first->x, first->y, particles.len - 1);
+
+    float sum = 0.0f;
+    for (auto chunk : particles.chunks()) {
+        sk::print("[{}] ", chunk.len);
+        for (auto& p : chunk) {
+            sum += p.x;
+        }
+    }
+    sk::println("sum of x = {:.1}", sum);
+}
+
+void slot_map_example() {
+    struct Entity {
+        const char* name;
+        int health;
+    };
+
+    auto entities = sk::OwnedSlotMap<Entity>{ sk::c_allocator };
+    auto player = entities.insert(Entity{ "player", 100 }).unwrap();
+    auto goblin = entities.insert(Entity{ "goblin", 30 }).unwrap();
+    auto troll = entities.insert(Entity{ "troll", 80 }).unwrap();
+
+    // Batch updates walk the live values only, packed together
+    for (auto& entity : entities.values()) {
+        entity.health -= 10;
+    }
+
+    entities.remove(goblin);
+    auto bat = entities.insert(Entity{ "bat", 5 }).unwrap();
+
+    // The bat reuses the goblin's slot, but the goblin's handle stays dead
+    sk::println("goblin {} -> alive: {}", goblin, entities.contains(goblin));
+    sk::println("bat    {} -> {}", bat, entities.get(bat).unwrap().name);
+    sk::println("player health {}, troll health {}", entities.get(player).unwrap().health, entities.get(troll).unwrap().health);
 }
 
 void owned_example() {
@@ -331,6 +1014,81 @@ int main() {
     arena_allocator_example();
     std::cout << std::endl;
 
+    arena_reset_example();
+    std::cout << std::endl;
+
+    virtual_arena_example();
+    std::cout << std::endl;
+
+    pool_allocator_example();
+    std::cout << std::endl;
+
+    size_class_allocator_example();
+    std::cout << std::endl;
+
+    concurrent_arena_example();
+    std::cout << std::endl;
+
+    scratch_example();
+    std::cout << std::endl;
+
+    static_allocator_list_example();
+    std::cout << std::endl;
+
+    tracking_allocator_example();
+    std::cout << std::endl;
+
+    allocation_balance_example();
+    std::cout << std::endl;
+
+    profiling_allocator_example();
+    std::cout << std::endl;
+
+    buddy_allocator_example();
+    std::cout << std::endl;
+
+    tlsf_allocator_example();
+    std::cout << std::endl;
+
+    huge_page_allocator_example();
+    std::cout << std::endl;
+
+    persistent_arena_example();
+    std::cout << std::endl;
+
+    batch_allocation_example();
+    std::cout << std::endl;
+
+    move_aware_list_example();
+    std::cout << std::endl;
+
+    bulk_list_example();
+    std::cout << std::endl;
+
+    small_list_example();
+    std::cout << std::endl;
+
+    hash_map_example();
+    std::cout << std::endl;
+
+    hash_set_example();
+    std::cout << std::endl;
+
+    flat_set_example();
+    std::cout << std::endl;
+
+    deque_example();
+    std::cout << std::endl;
+
+    lock_free_queue_example();
+    std::cout << std::endl;
+
+    segmented_list_example();
+    std::cout << std::endl;
+
+    slot_map_example();
+    std::cout << std::endl;
+
     owned_example();
     std::cout << std::endl;
 